@@ -0,0 +1,1414 @@
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <random>
+#include <cmath>
+#include <climits>
+#include <cstdlib>
+#include <ctime>
+
+#include <SFML/System.hpp>
+
+#include "carcassonne/db/db.h"
+#include "carcassonne/db/stmt.h"
+#include "carcassonne/db/transaction.h"
+#include "carcassonne/tileset.h"
+#include "carcassonne/pile.h"
+#include "carcassonne/player.h"
+#include "carcassonne/game_context.h"
+#include "carcassonne/game_state.h"
+#include "carcassonne/ai/monte_carlo_search.h"
+#include "carcassonne/ai/endgame_solver.h"
+#include "carcassonne/ai/evaluator.h"
+
+#ifdef DEBUG
+#pragma comment (lib, "sfml-system-d.lib")
+#else
+#pragma comment (lib, "sfml-system.lib")
+#endif
+
+// carcassonne-sim plays many games between machine players without a window,
+// either as a batch (reporting how each seat did), as a tournament (rating
+// the players against each other), or to tune the evaluator's weights.  Only
+// the rules (CCRules) are used; tiles are read straight from the tileset in
+// the assets database, so no OpenGL context is needed.
+
+enum BotType {
+   BOT_TRIVIAL,   // what the game does for SKILL_LEVEL_TRIVIAL players
+   BOT_RANDOM,    // a uniformly random legal move
+   BOT_GREEDY,    // the move with the best ai::Evaluator margin
+   BOT_MCTS       // the SKILL_LEVEL_HARD search, with a playout budget
+};
+
+struct BotConfig
+{
+   std::string name;
+   BotType type;
+   unsigned int playouts;  // only for BOT_MCTS
+   carcassonne::ai::Evaluator::Weights weights;   // only for BOT_GREEDY
+
+   BotConfig() : type(BOT_TRIVIAL), playouts(0) {}
+};
+
+// <type>[:<playouts>], e.g. "random", "trivial", "greedy", "mcts:2000"
+bool parseBot(const std::string& spec, BotConfig& bot)
+{
+   std::string type(spec.substr(0, spec.find(':')));
+   std::transform(type.begin(), type.end(), type.begin(), tolower);
+
+   bot.name = spec;
+   bot.playouts = 0;
+
+   if (type == "trivial")
+      bot.type = BOT_TRIVIAL;
+   else if (type == "random")
+      bot.type = BOT_RANDOM;
+   else if (type == "greedy")
+      bot.type = BOT_GREEDY;
+   else if (type == "mcts")
+   {
+      bot.type = BOT_MCTS;
+      bot.playouts = 1000;
+   }
+   else
+      return false;
+
+   if (type.size() < spec.size())
+   {
+      if (bot.type != BOT_MCTS)
+         return false;
+
+      int playouts(atoi(spec.c_str() + type.size() + 1));
+      if (playouts <= 0)
+         return false;
+
+      bot.playouts = static_cast<unsigned int>(playouts);
+   }
+
+   return true;
+}
+
+// Plays the turns of one seat in one game.
+class Bot
+{
+public:
+   Bot(const BotConfig& config, unsigned int seed)
+      : config_(config),
+        prng_(seed),
+        evaluator_(config.weights)
+   {
+      if (config_.type == BOT_MCTS)
+      {
+         // games are already played in parallel, so each search only gets
+         // one thread.
+         carcassonne::ai::MonteCarloSearch::Options options;
+         options.threads = 1;
+         options.playouts = config_.playouts;
+         options.time_limit = sf::Time::Zero;
+         options.seed = seed;
+         search_.reset(new carcassonne::ai::MonteCarloSearch(options));
+         solver_.reset(new carcassonne::ai::EndgameSolver(carcassonne::ai::EndgameSolver::Options()));
+      }
+   }
+
+   // Plays a complete turn for the current player of state.
+   void play(carcassonne::GameState& state)
+   {
+      if (config_.type == BOT_TRIVIAL)
+      {
+         const glm::ivec2* location = state.getNextPlaceableLocation();
+
+         while (location == nullptr)
+         {
+            state.rotateTileClockwise();
+            location = state.getNextPlaceableLocation();
+         }
+
+         glm::ivec2 loc = *location;
+         state.placeTile(loc);
+
+         if (state.getCurrentFollower())
+            state.placeFollower(state.getNearestPlaceholder(glm::vec3(), false));
+
+         return;
+      }
+
+      carcassonne::Move move;
+      float margin;
+
+      if (config_.type == BOT_RANDOM)
+         move = moves_[prng_() % getMoves(state)];
+      else if (config_.type == BOT_GREEDY)
+         move = evaluator_.getBestMove(state);
+      else if (!solver_->isApplicable(state) || !solver_->solve(state, move, margin))
+         move = search_->search(state);
+
+      if (!state.apply(move))
+         throw std::runtime_error("Bot \"" + config_.name + "\" chose an illegal move!");
+   }
+
+private:
+   size_t getMoves(carcassonne::GameState& state)
+   {
+      size_t count = state.getMoves(moves_.data(), moves_.size());
+      if (count > moves_.size())
+      {
+         moves_.resize(count);
+         count = state.getMoves(moves_.data(), moves_.size());
+      }
+
+      return count;
+   }
+
+   const BotConfig& config_;
+   std::mt19937 prng_;
+   std::vector<carcassonne::Move> moves_;
+   carcassonne::ai::Evaluator evaluator_;
+
+   std::unique_ptr<carcassonne::ai::MonteCarloSearch> search_;
+   std::unique_ptr<carcassonne::ai::EndgameSolver> solver_;
+
+   // Disable copy-construction & assignment - do not implement
+   Bot(const Bot&);
+   void operator=(const Bot&);
+};
+
+// The games waiting to be played by one worker thread.  Each worker takes
+// games from the back of its own queue, and when that runs out it steals
+// from the front of another worker's queue, so no thread sits idle while
+// there are games left (how long a game takes varies a lot, especially for
+// search bots).
+class WorkQueue
+{
+public:
+   WorkQueue() {}
+
+   void push(int game)
+   {
+      sf::Lock lock(mutex_);
+      games_.push_back(game);
+   }
+
+   bool pop(int& game)
+   {
+      sf::Lock lock(mutex_);
+      if (games_.empty())
+         return false;
+
+      game = games_.back();
+      games_.pop_back();
+      return true;
+   }
+
+   bool steal(int& game)
+   {
+      sf::Lock lock(mutex_);
+      if (games_.empty())
+         return false;
+
+      game = games_.front();
+      games_.pop_front();
+      return true;
+   }
+
+private:
+   sf::Mutex mutex_;
+   std::deque<int> games_;
+
+   // Disable copy-construction & assignment - do not implement
+   WorkQueue(const WorkQueue&);
+   void operator=(const WorkQueue&);
+};
+
+struct GameResult
+{
+   std::vector<int> scores;   // indexed by seat
+   int turns;
+
+   GameResult() : turns(0) {}
+};
+
+// Each game is dealt and played entirely from its own seed, so results don't
+// depend on the number of threads or which thread plays it.  bots are in
+// seat order.
+void playGame(const std::shared_ptr<const carcassonne::Tileset>& tileset,
+              const std::vector<BotConfig>& bot_configs, unsigned int seed, GameResult& result)
+{
+   carcassonne::GameContext context(seed);
+
+   std::vector<std::unique_ptr<Bot> > bots;
+   for (auto i(bot_configs.begin()), end(bot_configs.end()); i != end; ++i)
+   {
+      carcassonne::Player::SkillLevel skill_level = i->type == BOT_MCTS ? carcassonne::Player::SKILL_LEVEL_HARD : carcassonne::Player::SKILL_LEVEL_TRIVIAL;
+      context.addPlayer(i->name, false, skill_level, glm::vec4(1, 1, 1, 1));
+      bots.push_back(std::unique_ptr<Bot>(new Bot(*i, context.nextSeed())));
+   }
+
+   const std::vector<carcassonne::Player*>& seats = context.getPlayers();
+
+   carcassonne::Pile pile(tileset, context.nextSeed());
+   std::unique_ptr<carcassonne::Tile> starting_tile = pile.remove();
+   pile.shuffle();
+
+   carcassonne::GameState state(seats, std::move(pile), std::move(starting_tile));
+
+   while (!state.isGameOver())
+   {
+      size_t seat = std::find(seats.begin(), seats.end(), &state.getCurrentPlayer()) - seats.begin();
+      bots[seat]->play(state);
+      ++result.turns;
+   }
+
+   for (auto i(seats.begin()), end(seats.end()); i != end; ++i)
+      result.scores.push_back((*i)->getScore());
+}
+
+class Simulation
+{
+public:
+   Simulation(const std::shared_ptr<const carcassonne::Tileset>& tileset,
+              const std::vector<BotConfig>& bots, int games, unsigned int seed, unsigned int threads)
+      : tileset_(tileset),
+        bots_(bots),
+        seed_(seed),
+        results_(games),
+        stolen_(0)
+   {
+      // deal out contiguous runs of games, so workers only steal once their
+      // own run is finished.
+      for (unsigned int i = 0; i < threads; ++i)
+         queues_.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+
+      for (int game = games - 1; game >= 0; --game)
+         queues_[game * threads / games]->push(game);
+   }
+
+   void run()
+   {
+      std::vector<std::unique_ptr<Worker> > workers;
+      std::vector<std::unique_ptr<sf::Thread> > threads;
+
+      for (size_t i = 0; i < queues_.size(); ++i)
+      {
+         workers.push_back(std::unique_ptr<Worker>(new Worker(*this, i)));
+         threads.push_back(std::unique_ptr<sf::Thread>(new sf::Thread(&Worker::run, workers.back().get())));
+         threads.back()->launch();
+      }
+
+      for (auto i(threads.begin()), end(threads.end()); i != end; ++i)
+         (*i)->wait();
+   }
+
+   const std::vector<GameResult>& getResults() const { return results_; }
+   int getStolenGames() const { return stolen_; }
+   const std::string& getError() const { return error_; }
+
+private:
+   struct Worker
+   {
+      Simulation& simulation;
+      size_t index;
+
+      Worker(Simulation& simulation, size_t index) : simulation(simulation), index(index) {}
+      void run() { simulation.work(index); }
+
+   private:
+      void operator=(const Worker&);
+   };
+
+   bool nextGame(size_t worker, int& game)
+   {
+      if (queues_[worker]->pop(game))
+         return true;
+
+      for (size_t i = 1; i < queues_.size(); ++i)
+      {
+         if (queues_[(worker + i) % queues_.size()]->steal(game))
+         {
+            sf::Lock lock(mutex_);
+            ++stolen_;
+            return true;
+         }
+      }
+
+      return false;
+   }
+
+   void work(size_t worker)
+   {
+      int game;
+      while (nextGame(worker, game))
+      {
+         try
+         {
+            playGame(tileset_, bots_, seed_ + game, results_[game]);
+         }
+         catch (const std::exception& e)
+         {
+            std::ostringstream oss;
+            oss << "Game " << game << ": " << e.what();
+
+            sf::Lock lock(mutex_);
+            if (error_.empty())
+               error_ = oss.str();
+         }
+      }
+   }
+
+   std::shared_ptr<const carcassonne::Tileset> tileset_;
+   const std::vector<BotConfig>& bots_;
+   unsigned int seed_;
+
+   std::vector<std::unique_ptr<WorkQueue> > queues_;
+   std::vector<GameResult> results_;   // indexed by game
+
+   sf::Mutex mutex_;    // guards stolen_ and error_
+   int stolen_;
+   std::string error_;
+
+   // Disable copy-construction & assignment - do not implement
+   Simulation(const Simulation&);
+   void operator=(const Simulation&);
+};
+
+void printReport(const std::vector<BotConfig>& bots, const std::vector<GameResult>& results)
+{
+   enum { BIN_SIZE = 10 };
+
+   size_t seats = bots.size();
+   std::vector<double> wins(seats), sum(seats), sum_squares(seats);
+   std::vector<int> min_score(seats, INT_MAX), max_score(seats, 0);
+   std::vector<std::vector<int> > histogram(seats);
+   int ties(0), turns(0);
+
+   for (auto i(results.begin()), end(results.end()); i != end; ++i)
+   {
+      int best = *std::max_element(i->scores.begin(), i->scores.end());
+      int winners = static_cast<int>(std::count(i->scores.begin(), i->scores.end(), best));
+      if (winners > 1)
+         ++ties;
+
+      turns += i->turns;
+
+      for (size_t seat = 0; seat < seats; ++seat)
+      {
+         int score = i->scores[seat];
+
+         // a tie splits the win between the winners
+         if (score == best)
+            wins[seat] += 1.0 / winners;
+
+         sum[seat] += score;
+         sum_squares[seat] += double(score) * score;
+         min_score[seat] = std::min(min_score[seat], score);
+         max_score[seat] = std::max(max_score[seat], score);
+
+         size_t bin = score / BIN_SIZE;
+         if (histogram[seat].size() <= bin)
+            histogram[seat].resize(bin + 1);
+         ++histogram[seat][bin];
+      }
+   }
+
+   double games = double(results.size());
+
+   std::cout << std::endl
+             << "seat  player              wins     win%     mean   stddev    min    max" << std::endl;
+
+   for (size_t seat = 0; seat < seats; ++seat)
+   {
+      double mean = sum[seat] / games;
+      double variance = std::max(0.0, sum_squares[seat] / games - mean * mean);
+
+      std::cout << std::setw(4) << seat + 1 << "  "
+                << std::left << std::setw(16) << bots[seat].name << std::right
+                << std::fixed << std::setprecision(1)
+                << std::setw(8) << wins[seat]
+                << std::setw(8) << 100.0 * wins[seat] / games << '%'
+                << std::setw(9) << mean
+                << std::setw(9) << std::sqrt(variance)
+                << std::setw(7) << min_score[seat]
+                << std::setw(7) << max_score[seat] << std::endl;
+   }
+
+   std::cout << std::endl
+             << ties << " ties, " << std::setprecision(1) << turns / games << " turns/game" << std::endl
+             << std::endl
+             << "score     ";
+
+   size_t bins(0);
+   for (size_t seat = 0; seat < seats; ++seat)
+   {
+      bins = std::max(bins, histogram[seat].size());
+      std::cout << std::setw(8) << seat + 1;
+   }
+   std::cout << std::endl;
+
+   for (size_t bin = 0; bin < bins; ++bin)
+   {
+      std::ostringstream range;
+      range << bin * BIN_SIZE << '-' << (bin + 1) * BIN_SIZE - 1;
+      std::cout << std::left << std::setw(10) << range.str() << std::right;
+
+      for (size_t seat = 0; seat < seats; ++seat)
+         std::cout << std::setw(8) << (bin < histogram[seat].size() ? histogram[seat][bin] : 0);
+
+      std::cout << std::endl;
+   }
+}
+
+// A tournament is a series of 2-player matches (pairings) between entrants.
+// Each match is played in game pairs: two games dealt from the same seed,
+// with the entrants swapping seats, so neither the deal nor moving first
+// favors either of them.
+enum TournamentFormat {
+   FORMAT_ROUND_ROBIN,  // every entrant plays every other entrant
+   FORMAT_GAUNTLET      // the first entrant plays each of the others
+};
+
+// Each pairing is stopped early once a sequential probability ratio test
+// decides between H0: the first entrant is SPRT_ELO0 stronger than the
+// second and H1: it is SPRT_ELO1 stronger, with false positive & negative
+// rates of SPRT_ALPHA & SPRT_BETA.
+const double SPRT_ELO0 = 0.0;
+const double SPRT_ELO1 = 20.0;
+const double SPRT_ALPHA = 0.05;
+const double SPRT_BETA = 0.05;
+
+// 95% confidence intervals are +/- this many standard errors.
+const double CONFIDENCE_Z = 1.96;
+
+// The expected score of a player rated elo points higher than their opponent.
+double eloToScore(double elo)
+{
+   return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double scoreToElo(double score)
+{
+   score = std::min(std::max(score, 0.001), 0.999);
+   return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// 1 for a win, 0.5 for a tie, 0 for a loss.
+double getGameScore(const GameResult& result, size_t seat)
+{
+   int mine = result.scores[seat];
+   int theirs = result.scores[1 - seat];
+   return mine > theirs ? 1.0 : (mine == theirs ? 0.5 : 0.0);
+}
+
+struct Pairing
+{
+   size_t first;        // entrant indices
+   size_t second;
+
+   // the number of game pairs in which first scored 0, 0.5, 1, 1.5, and 2.
+   // Game pairs are the samples for the SPRT and confidence intervals,
+   // since the two games of a pair are dealt the same tiles.
+   int pentanomial[5];
+   int pairs;
+
+   double llr;          // the SPRT's log-likelihood ratio
+   int verdict;         // -1 => H0 accepted, 1 => H1 accepted, 0 => undecided
+
+   Pairing(size_t first, size_t second)
+      : first(first),
+        second(second),
+        pairs(0),
+        llr(0),
+        verdict(0)
+   {
+      std::fill(pentanomial, pentanomial + 5, 0);
+   }
+
+   void add(double pair_score)
+   {
+      ++pentanomial[static_cast<int>(pair_score * 2.0 + 0.5)];
+      ++pairs;
+
+      double mean, variance;
+      getScore(mean, variance, true);
+
+      double s0 = eloToScore(SPRT_ELO0);
+      double s1 = eloToScore(SPRT_ELO1);
+      llr = (pairs + 1) * (s1 - s0) * (2.0 * mean - s0 - s1) / (2.0 * variance);
+
+      if (llr >= std::log((1.0 - SPRT_BETA) / SPRT_ALPHA))
+         verdict = 1;
+      else if (llr <= std::log(SPRT_BETA / (1.0 - SPRT_ALPHA)))
+         verdict = -1;
+   }
+
+   // The mean of first's per-game score over each game pair, and its
+   // variance between game pairs.  If regularize is true, half a game pair
+   // is added at each extreme, so a few lopsided pairs don't look like a
+   // certainty (the variance would be 0).
+   void getScore(double& mean, double& variance, bool regularize) const
+   {
+      double counts[5];
+      double total = 0;
+      for (int i = 0; i < 5; ++i)
+         total += counts[i] = pentanomial[i];
+
+      if (regularize)
+      {
+         counts[0] += 0.5;
+         counts[4] += 0.5;
+         total += 1.0;
+      }
+
+      mean = variance = 0;
+      if (total <= 0)
+         return;
+
+      for (int i = 0; i < 5; ++i)
+         mean += counts[i] * i / 4.0;
+      mean /= total;
+
+      for (int i = 0; i < 5; ++i)
+         variance += counts[i] * (i / 4.0 - mean) * (i / 4.0 - mean);
+      variance /= total;
+   }
+};
+
+// Bradley-Terry ratings for every entrant, found by minorization-
+// maximization (as in BayesElo, but counting ties as half a win instead of
+// modelling them separately).  Like BayesElo, PRIOR_DRAWS virtual ties are
+// added to every pairing, so an entrant that won or lost every game still
+// gets a finite rating.  Ratings are relative to the average entrant.
+void computeRatings(size_t entrants, const std::vector<Pairing>& pairings,
+                    std::vector<double>& elo, std::vector<double>& error)
+{
+   const double PRIOR_DRAWS = 2.0;
+
+   std::vector<std::vector<double> > games(entrants, std::vector<double>(entrants));
+   std::vector<double> wins(entrants);
+
+   for (auto i(pairings.begin()), end(pairings.end()); i != end; ++i)
+   {
+      double mean, variance;
+      i->getScore(mean, variance, false);
+
+      double n = 2.0 * i->pairs + PRIOR_DRAWS;
+      games[i->first][i->second] += n;
+      games[i->second][i->first] += n;
+      wins[i->first] += 2.0 * i->pairs * mean + PRIOR_DRAWS / 2;
+      wins[i->second] += 2.0 * i->pairs * (1.0 - mean) + PRIOR_DRAWS / 2;
+   }
+
+   std::vector<double> gamma(entrants, 1.0);
+   for (int iteration = 0; iteration < 1000; ++iteration)
+   {
+      double change = 0;
+      double log_sum = 0;
+
+      for (size_t i = 0; i < entrants; ++i)
+      {
+         double denominator = 0;
+         for (size_t j = 0; j < entrants; ++j)
+         {
+            if (games[i][j] > 0)
+               denominator += games[i][j] / (gamma[i] + gamma[j]);
+         }
+
+         double updated = denominator > 0 ? wins[i] / denominator : 1.0;
+         change = std::max(change, std::abs(std::log(updated / gamma[i])));
+         gamma[i] = updated;
+         log_sum += std::log(updated);
+      }
+
+      double scale = std::exp(-log_sum / entrants);
+      for (size_t i = 0; i < entrants; ++i)
+         gamma[i] *= scale;
+
+      if (change < 1e-9)
+         break;
+   }
+
+   // the standard error of each rating from the Fisher information
+   const double ELO_PER_NEPER = 400.0 / std::log(10.0);
+
+   elo.assign(entrants, 0);
+   error.assign(entrants, 0);
+   for (size_t i = 0; i < entrants; ++i)
+   {
+      double information = 0;
+      for (size_t j = 0; j < entrants; ++j)
+      {
+         double p = gamma[i] / (gamma[i] + gamma[j]);
+         information += games[i][j] * p * (1.0 - p);
+      }
+
+      elo[i] = ELO_PER_NEPER * std::log(gamma[i]);
+      error[i] = information > 0 ? CONFIDENCE_Z * ELO_PER_NEPER / std::sqrt(information) : 0;
+   }
+}
+
+struct TournamentGame
+{
+   size_t pairing;
+   int game_pair;
+   bool swapped;        // true if the pairing's second entrant had seat 1
+   GameResult result;
+};
+
+class Tournament
+{
+public:
+   Tournament(const std::shared_ptr<const carcassonne::Tileset>& tileset,
+              const std::vector<BotConfig>& entrants, TournamentFormat format,
+              int game_pairs, unsigned int seed, unsigned int threads)
+      : tileset_(tileset),
+        entrants_(entrants),
+        seed_(seed),
+        threads_(threads),
+        next_job_(0)
+   {
+      for (size_t i = 0; i < entrants_.size(); ++i)
+      {
+         for (size_t j = i + 1; j < entrants_.size(); ++j)
+         {
+            if (format == FORMAT_ROUND_ROBIN || i == 0)
+               pairings_.push_back(Pairing(i, j));
+         }
+      }
+
+      // every pairing plays game pair 0 before any plays game pair 1, so
+      // pairings progress evenly and every pairing plays the same deals.
+      for (int game_pair = 0; game_pair < game_pairs; ++game_pair)
+      {
+         for (size_t pairing = 0; pairing < pairings_.size(); ++pairing)
+            jobs_.push_back(Job(pairing, game_pair));
+      }
+   }
+
+   void run()
+   {
+      std::vector<std::unique_ptr<Worker> > workers;
+      std::vector<std::unique_ptr<sf::Thread> > threads;
+
+      for (unsigned int i = 0; i < threads_; ++i)
+      {
+         workers.push_back(std::unique_ptr<Worker>(new Worker(*this)));
+         threads.push_back(std::unique_ptr<sf::Thread>(new sf::Thread(&Worker::run, workers.back().get())));
+         threads.back()->launch();
+      }
+
+      for (auto i(threads.begin()), end(threads.end()); i != end; ++i)
+         (*i)->wait();
+   }
+
+   const std::vector<Pairing>& getPairings() const { return pairings_; }
+   const std::vector<TournamentGame>& getGames() const { return games_; }
+   unsigned int getSeed(int game_pair) const { return seed_ + game_pair; }
+   const std::string& getError() const { return error_; }
+
+private:
+   struct Job
+   {
+      size_t pairing;
+      int game_pair;
+
+      Job(size_t pairing, int game_pair) : pairing(pairing), game_pair(game_pair) {}
+   };
+
+   struct Worker
+   {
+      Tournament& tournament;
+
+      explicit Worker(Tournament& tournament) : tournament(tournament) {}
+      void run() { tournament.work(); }
+
+   private:
+      void operator=(const Worker&);
+   };
+
+   // Skips the game pairs of pairings which the SPRT has already decided.
+   // Game pairs which were started before the verdict are still recorded.
+   bool nextJob(size_t& job)
+   {
+      sf::Lock lock(mutex_);
+
+      while (next_job_ < jobs_.size() && pairings_[jobs_[next_job_].pairing].verdict != 0)
+         ++next_job_;
+
+      if (next_job_ == jobs_.size() || !error_.empty())
+         return false;
+
+      job = next_job_++;
+      return true;
+   }
+
+   void work()
+   {
+      size_t job;
+      while (nextJob(job))
+      {
+         const Pairing& pairing = pairings_[jobs_[job].pairing];
+         unsigned int seed = getSeed(jobs_[job].game_pair);
+
+         std::vector<BotConfig> seats;
+         seats.push_back(entrants_[pairing.first]);
+         seats.push_back(entrants_[pairing.second]);
+
+         try
+         {
+            TournamentGame games[2];
+            for (int i = 0; i < 2; ++i)
+            {
+               games[i].pairing = jobs_[job].pairing;
+               games[i].game_pair = jobs_[job].game_pair;
+               games[i].swapped = i == 1;
+
+               if (i == 1)
+                  std::swap(seats[0], seats[1]);
+
+               playGame(tileset_, seats, seed, games[i].result);
+            }
+
+            record(games);
+         }
+         catch (const std::exception& e)
+         {
+            std::ostringstream oss;
+            oss << "Game pair " << jobs_[job].game_pair << " of " << seats[0].name << " vs. " << seats[1].name << ": " << e.what();
+
+            sf::Lock lock(mutex_);
+            if (error_.empty())
+               error_ = oss.str();
+         }
+      }
+   }
+
+   void record(const TournamentGame (&games)[2])
+   {
+      sf::Lock lock(mutex_);
+
+      Pairing& pairing = pairings_[games[0].pairing];
+      double score = getGameScore(games[0].result, 0) + getGameScore(games[1].result, 1);
+
+      games_.push_back(games[0]);
+      games_.push_back(games[1]);
+
+      if (pairing.verdict == 0)
+      {
+         pairing.add(score);
+
+         if (pairing.verdict != 0)
+            std::cout << entrants_[pairing.first].name << " vs. " << entrants_[pairing.second].name
+                      << ": H" << (pairing.verdict > 0 ? 1 : 0) << " accepted after "
+                      << pairing.pairs << " game pairs" << std::endl;
+      }
+   }
+
+   std::shared_ptr<const carcassonne::Tileset> tileset_;
+   const std::vector<BotConfig>& entrants_;
+   unsigned int seed_;
+   unsigned int threads_;
+
+   std::vector<Job> jobs_;
+
+   sf::Mutex mutex_;    // guards everything below
+   size_t next_job_;
+   std::vector<Pairing> pairings_;
+   std::vector<TournamentGame> games_;   // in the order they finished
+   std::string error_;
+
+   // Disable copy-construction & assignment - do not implement
+   Tournament(const Tournament&);
+   void operator=(const Tournament&);
+};
+
+void printTournamentReport(const std::vector<BotConfig>& entrants, const std::vector<Pairing>& pairings,
+                           const std::vector<double>& elo, const std::vector<double>& error)
+{
+   std::vector<int> games(entrants.size());
+   std::vector<double> score(entrants.size());
+
+   for (auto i(pairings.begin()), end(pairings.end()); i != end; ++i)
+   {
+      double mean, variance;
+      i->getScore(mean, variance, false);
+
+      games[i->first] += 2 * i->pairs;
+      games[i->second] += 2 * i->pairs;
+      score[i->first] += 2 * i->pairs * mean;
+      score[i->second] += 2 * i->pairs * (1.0 - mean);
+   }
+
+   std::cout << std::endl
+             << "player              games   score      elo     +/-" << std::endl
+             << std::fixed << std::setprecision(1);
+
+   for (size_t i = 0; i < entrants.size(); ++i)
+   {
+      std::cout << std::left << std::setw(16) << entrants[i].name << std::right
+                << std::setw(9) << games[i]
+                << std::setw(7) << (games[i] > 0 ? 100.0 * score[i] / games[i] : 0.0) << '%'
+                << std::setw(9) << std::showpos << elo[i] << std::noshowpos
+                << std::setw(8) << error[i] << std::endl;
+   }
+
+   std::cout << std::endl
+             << "pairing                          pairs   score      elo     +/-     llr  verdict" << std::endl;
+
+   for (auto i(pairings.begin()), end(pairings.end()); i != end; ++i)
+   {
+      double mean, variance, unused;
+      i->getScore(mean, unused, false);
+      i->getScore(unused, variance, true);
+
+      // the confidence interval of the mean score, converted to elo
+      double margin = i->pairs > 0 ? CONFIDENCE_Z * std::sqrt(variance / i->pairs) : 0.5;
+      double low = scoreToElo(mean - margin);
+      double high = scoreToElo(mean + margin);
+
+      std::string name(entrants[i->first].name + " vs. " + entrants[i->second].name);
+      std::cout << std::left << std::setw(32) << name << std::right
+                << std::setw(6) << i->pairs
+                << std::setw(7) << 100.0 * mean << '%'
+                << std::setw(9) << std::showpos << scoreToElo(mean) << std::noshowpos
+                << std::setw(8) << (high - low) / 2
+                << std::setw(8) << std::setprecision(2) << i->llr << std::setprecision(1)
+                << "  " << (i->verdict > 0 ? "H1" : (i->verdict < 0 ? "H0" : "-")) << std::endl;
+   }
+}
+
+// Every game, the final standings of each pairing, and the ratings are
+// written in one transaction.
+void saveTournament(const std::string& filename, const std::string& tileset_name, TournamentFormat format,
+                    const std::vector<BotConfig>& entrants, const Tournament& tournament,
+                    const std::vector<double>& elo, const std::vector<double>& error)
+{
+   carcassonne::db::DB db(filename);
+   carcassonne::db::Transaction transaction(db);
+
+   db.exec("CREATE TABLE IF NOT EXISTS cc_tournaments ("
+           "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+           "time INTEGER, "
+           "tileset TEXT, "
+           "format TEXT, "
+           "sprt_elo0 REAL, "
+           "sprt_elo1 REAL)");
+
+   db.exec("CREATE TABLE IF NOT EXISTS cc_tournament_games ("
+           "tournament INTEGER, "
+           "game_pair INTEGER, "
+           "seed INTEGER, "
+           "player1 TEXT, "
+           "player2 TEXT, "
+           "score1 INTEGER, "
+           "score2 INTEGER, "
+           "turns INTEGER)");
+
+   db.exec("CREATE TABLE IF NOT EXISTS cc_tournament_pairings ("
+           "tournament INTEGER, "
+           "player1 TEXT, "
+           "player2 TEXT, "
+           "game_pairs INTEGER, "
+           "score REAL, "
+           "llr REAL, "
+           "verdict INTEGER)");
+
+   db.exec("CREATE TABLE IF NOT EXISTS cc_tournament_ratings ("
+           "tournament INTEGER, "
+           "player TEXT, "
+           "elo REAL, "
+           "elo_error REAL)");
+
+   carcassonne::db::Stmt s(db, "INSERT INTO cc_tournaments (time, tileset, format, sprt_elo0, sprt_elo1) VALUES (?,?,?,?,?)");
+   s.bind(1, static_cast<sqlite3_int64>(time(nullptr)));
+   s.bind(2, tileset_name);
+   s.bind(3, format == FORMAT_GAUNTLET ? "gauntlet" : "round-robin");
+   s.bind(4, SPRT_ELO0);
+   s.bind(5, SPRT_ELO1);
+   s.step();
+
+   int id = db.getInt("SELECT last_insert_rowid()", 0);
+
+   const std::vector<Pairing>& pairings = tournament.getPairings();
+   const std::vector<TournamentGame>& games = tournament.getGames();
+
+   carcassonne::db::Stmt game(db, "INSERT INTO cc_tournament_games ("
+                                  "tournament, game_pair, seed, player1, player2, score1, score2, turns"
+                                  ") VALUES (?,?,?,?,?,?,?,?)");
+   for (auto i(games.begin()), end(games.end()); i != end; ++i)
+   {
+      const Pairing& pairing = pairings[i->pairing];
+      size_t player1 = i->swapped ? pairing.second : pairing.first;
+      size_t player2 = i->swapped ? pairing.first : pairing.second;
+
+      game.bind(1, id);
+      game.bind(2, i->game_pair);
+      game.bind(3, static_cast<sqlite3_int64>(tournament.getSeed(i->game_pair)));
+      game.bind(4, entrants[player1].name);
+      game.bind(5, entrants[player2].name);
+      game.bind(6, i->result.scores[0]);
+      game.bind(7, i->result.scores[1]);
+      game.bind(8, i->result.turns);
+      game.step();
+      game.reset();
+   }
+
+   carcassonne::db::Stmt pairing(db, "INSERT INTO cc_tournament_pairings ("
+                                     "tournament, player1, player2, game_pairs, score, llr, verdict"
+                                     ") VALUES (?,?,?,?,?,?,?)");
+   for (auto i(pairings.begin()), end(pairings.end()); i != end; ++i)
+   {
+      double mean, variance;
+      i->getScore(mean, variance, false);
+
+      pairing.bind(1, id);
+      pairing.bind(2, entrants[i->first].name);
+      pairing.bind(3, entrants[i->second].name);
+      pairing.bind(4, i->pairs);
+      pairing.bind(5, mean);
+      pairing.bind(6, i->llr);
+      pairing.bind(7, i->verdict);
+      pairing.step();
+      pairing.reset();
+   }
+
+   carcassonne::db::Stmt rating(db, "INSERT INTO cc_tournament_ratings (tournament, player, elo, elo_error) VALUES (?,?,?,?)");
+   for (size_t i = 0; i < entrants.size(); ++i)
+   {
+      rating.bind(1, id);
+      rating.bind(2, entrants[i].name);
+      rating.bind(3, elo[i]);
+      rating.bind(4, error[i]);
+      rating.step();
+      rating.reset();
+   }
+
+   transaction.commit();
+}
+
+bool parsePlayers(int argc, char** argv, int first, std::vector<BotConfig>& bots)
+{
+   for (int i = first; i < argc; ++i)
+   {
+      BotConfig bot;
+      if (!parseBot(argv[i], bot))
+      {
+         std::cerr << "Unrecognized player \"" << argv[i] << "\"!" << std::endl;
+         return false;
+      }
+      bots.push_back(bot);
+   }
+
+   return true;
+}
+
+std::shared_ptr<const carcassonne::Tileset> loadTileset(const std::string& filename, const std::string& tileset_name)
+{
+   carcassonne::db::DB db(filename);
+   return std::make_shared<carcassonne::Tileset>(db, tileset_name);
+}
+
+int batch(int argc, char** argv)
+{
+   if (argc < 9)
+   {
+      std::cerr << "Not enough parameters!" << std::endl;
+      return -1;
+   }
+
+   std::string filename(argv[1]);
+   std::string tileset_name(argv[2]);
+   int games(atoi(argv[4]));
+   unsigned int seed(static_cast<unsigned int>(strtoul(argv[5], nullptr, 10)));
+   int threads(atoi(argv[6]));
+
+   if (games <= 0)
+   {
+      std::cerr << "At least one game must be played!" << std::endl;
+      return -1;
+   }
+
+   if (threads <= 0)
+      threads = carcassonne::ai::MonteCarloSearch::getHardwareThreads();
+   threads = std::min(threads, games);
+
+   std::vector<BotConfig> bots;
+   if (!parsePlayers(argc, argv, 7, bots))
+      return -1;
+
+   try
+   {
+      std::shared_ptr<const carcassonne::Tileset> tileset(loadTileset(filename, tileset_name));
+
+      std::cout << games << " games of " << tileset_name << " (seed " << seed << ") on "
+                << threads << " threads..." << std::endl;
+
+      Simulation simulation(tileset, bots, games, seed, threads);
+
+      sf::Clock clock;
+      simulation.run();
+      sf::Time elapsed = clock.getElapsedTime();
+
+      if (!simulation.getError().empty())
+         throw std::runtime_error(simulation.getError());
+
+      printReport(bots, simulation.getResults());
+
+      std::cout << std::endl
+                << std::setprecision(2) << elapsed.asSeconds() << "s, "
+                << games / std::max(elapsed.asSeconds(), 0.001f) << " games/s ("
+                << simulation.getStolenGames() << " games stolen)" << std::endl;
+   }
+   catch (const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
+
+int tournament(int argc, char** argv)
+{
+   if (argc < 11)
+   {
+      std::cerr << "Not enough parameters!" << std::endl;
+      return -1;
+   }
+
+   std::string filename(argv[1]);
+   std::string tileset_name(argv[2]);
+   std::string results_filename(argv[4]);
+   std::string format_name(argv[5]);
+   int game_pairs(atoi(argv[6]));
+   unsigned int seed(static_cast<unsigned int>(strtoul(argv[7], nullptr, 10)));
+   int threads(atoi(argv[8]));
+
+   std::transform(format_name.begin(), format_name.end(), format_name.begin(), tolower);
+
+   TournamentFormat format;
+   if (format_name == "round-robin")
+      format = FORMAT_ROUND_ROBIN;
+   else if (format_name == "gauntlet")
+      format = FORMAT_GAUNTLET;
+   else
+   {
+      std::cerr << "Unrecognized tournament format!" << std::endl;
+      return -1;
+   }
+
+   if (game_pairs <= 0)
+   {
+      std::cerr << "At least one game pair must be played!" << std::endl;
+      return -1;
+   }
+
+   if (threads <= 0)
+      threads = carcassonne::ai::MonteCarloSearch::getHardwareThreads();
+
+   std::vector<BotConfig> entrants;
+   if (!parsePlayers(argc, argv, 9, entrants))
+      return -1;
+
+   // the same player can be entered more than once, e.g. to check for seat
+   // bias, but every entrant needs a distinct name in the results.
+   for (size_t i = entrants.size() - 1; i > 0; --i)
+   {
+      int copies = 1;
+      for (size_t j = 0; j < i; ++j)
+      {
+         if (entrants[j].name == entrants[i].name)
+            ++copies;
+      }
+
+      if (copies > 1)
+      {
+         std::ostringstream oss;
+         oss << entrants[i].name << '#' << copies;
+         entrants[i].name = oss.str();
+      }
+   }
+
+   try
+   {
+      std::shared_ptr<const carcassonne::Tileset> tileset(loadTileset(filename, tileset_name));
+
+      std::cout << format_name << " tournament of " << entrants.size() << " players, up to "
+                << game_pairs << " game pairs per pairing, on " << tileset_name << " (seed " << seed << ") on "
+                << threads << " threads..." << std::endl;
+
+      Tournament tournament(tileset, entrants, format, game_pairs, seed, threads);
+
+      sf::Clock clock;
+      tournament.run();
+      sf::Time elapsed = clock.getElapsedTime();
+
+      if (!tournament.getError().empty())
+         throw std::runtime_error(tournament.getError());
+
+      std::vector<double> elo, error;
+      computeRatings(entrants.size(), tournament.getPairings(), elo, error);
+
+      printTournamentReport(entrants, tournament.getPairings(), elo, error);
+
+      saveTournament(results_filename, tileset_name, format, entrants, tournament, elo, error);
+
+      std::cout << std::endl
+                << std::setprecision(2) << elapsed.asSeconds() << "s, "
+                << tournament.getGames().size() << " games; results saved to " << results_filename << std::endl;
+   }
+   catch (const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
+
+// Tuning uses simultaneous perturbation stochastic approximation (Spall's
+// SPSA).  Each iteration perturbs every evaluator weight by +/- c_k at
+// once, plays greedy bots using the two perturbed weight sets against each
+// other, and moves the weights a_k times the estimated gradient.  Weights
+// are perturbed relative to their default values, so they can be on
+// different scales.
+const double SPSA_A = 0.05;            // a: step size
+const double SPSA_C = 0.2;             // c: perturbation size
+const double SPSA_STABILITY = 10.0;    // A: delays the decay of a_k
+const double SPSA_ALPHA = 0.602;       // a_k = a / (k + 1 + A)^alpha
+const double SPSA_GAMMA = 0.101;       // c_k = c / (k + 1)^gamma
+
+// The last tuning checkpoint in the configuration database, if there is one.
+bool loadTuningCheckpoint(carcassonne::db::DB& db, int& iteration, unsigned int& seed)
+{
+   if (db.getInt("SELECT count(*) "
+                 "FROM sqlite_master "
+                 "WHERE type='table' "
+                 "AND name='cc_ai_tuning'", 0) == 0)
+      return false;
+
+   carcassonne::db::Stmt s(db, "SELECT iteration, seed FROM cc_ai_tuning ORDER BY ROWID DESC LIMIT 1");
+   if (!s.step())
+      return false;
+
+   iteration = s.getInt(0);
+   seed = static_cast<unsigned int>(s.getLong(1));
+   return true;
+}
+
+// Saves the weights (where the game will use them) and the number of
+// iterations finished, so an interrupted run can be resumed.  Old
+// checkpoints are kept, so the tuning history can be inspected.
+void saveTuningCheckpoint(carcassonne::db::DB& db, int iteration, unsigned int seed, double result,
+                          const carcassonne::ai::Evaluator::Weights& weights)
+{
+   carcassonne::db::Transaction transaction(db);
+
+   if (!weights.save(db))
+      throw std::runtime_error("Could not save evaluator weights!");
+
+   db.exec("CREATE TABLE IF NOT EXISTS cc_ai_tuning ("
+           "ROWID INTEGER PRIMARY KEY AUTOINCREMENT, "
+           "iteration INTEGER, "
+           "seed INTEGER, "
+           "result REAL)");
+
+   carcassonne::db::Stmt s(db, "INSERT INTO cc_ai_tuning (iteration, seed, result) VALUES (?,?,?)");
+   s.bind(1, iteration);
+   s.bind(2, static_cast<sqlite3_int64>(seed));
+   s.bind(3, result);
+   s.step();
+
+   transaction.commit();
+}
+
+// The total score (see getGameScore()) of the bot in seat over a batch of
+// two-player games, minus that of its opponent.
+double getScoreDifference(const std::vector<GameResult>& results, size_t seat)
+{
+   double difference = 0;
+   for (auto i(results.begin()), end(results.end()); i != end; ++i)
+      difference += getGameScore(*i, seat) - getGameScore(*i, 1 - seat);
+
+   return difference;
+}
+
+int tune(int argc, char** argv)
+{
+   if (argc < 9)
+   {
+      std::cerr << "Not enough parameters!" << std::endl;
+      return -1;
+   }
+
+   std::string filename(argv[1]);
+   std::string tileset_name(argv[2]);
+   std::string config_filename(argv[4]);
+   int iterations(atoi(argv[5]));
+   int game_pairs(atoi(argv[6]));
+   unsigned int seed(static_cast<unsigned int>(strtoul(argv[7], nullptr, 10)));
+   int threads(atoi(argv[8]));
+
+   if (game_pairs <= 0)
+   {
+      std::cerr << "At least one game pair must be played per iteration!" << std::endl;
+      return -1;
+   }
+
+   if (threads <= 0)
+      threads = carcassonne::ai::MonteCarloSearch::getHardwareThreads();
+   threads = std::min(threads, game_pairs);
+
+   try
+   {
+      std::shared_ptr<const carcassonne::Tileset> tileset(loadTileset(filename, tileset_name));
+      carcassonne::db::DB db(config_filename);
+
+      typedef carcassonne::ai::Evaluator::Weights Weights;
+      const Weights defaults;
+      Weights weights(Weights::load(db));
+
+      int iteration = 0;
+      if (loadTuningCheckpoint(db, iteration, seed))
+         std::cout << "Resuming after iteration " << iteration << " (seed " << seed << ")" << std::endl;
+
+      std::cout << "Tuning " << Weights::size() << " weights, " << game_pairs << " game pairs per iteration, on "
+                << threads << " threads..." << std::endl;
+
+      for (; iteration < iterations; ++iteration)
+      {
+         double a = SPSA_A / std::pow(iteration + 1 + SPSA_STABILITY, SPSA_ALPHA);
+         double c = SPSA_C / std::pow(iteration + 1.0, SPSA_GAMMA);
+
+         // each weight is perturbed up or down at random
+         std::mt19937 prng(seed + iteration);
+         std::vector<int> delta(Weights::size());
+
+         std::vector<BotConfig> bots(2);
+         bots[0].name = "greedy+";
+         bots[1].name = "greedy-";
+         for (size_t i = 0; i < Weights::size(); ++i)
+         {
+            delta[i] = (prng() & 1) ? 1 : -1;
+
+            double step = c * delta[i] * defaults[i];
+            bots[0].type = bots[1].type = BOT_GREEDY;
+            bots[0].weights[i] = static_cast<float>(std::max(0.0, weights[i] + step));
+            bots[1].weights[i] = static_cast<float>(std::max(0.0, weights[i] - step));
+         }
+
+         // both halves of each game pair use the same deal, with the bots
+         // in swapped seats
+         unsigned int games_seed = seed + iteration * game_pairs;
+
+         Simulation first(tileset, bots, game_pairs, games_seed, threads);
+         first.run();
+
+         std::swap(bots[0], bots[1]);
+         Simulation second(tileset, bots, game_pairs, games_seed, threads);
+         second.run();
+
+         if (!first.getError().empty())
+            throw std::runtime_error(first.getError());
+         if (!second.getError().empty())
+            throw std::runtime_error(second.getError());
+
+         // how much better the + weights did than the - weights, per game
+         double result = (getScoreDifference(first.getResults(), 0) + getScoreDifference(second.getResults(), 1)) / (2.0 * game_pairs);
+
+         std::cout << "iteration " << iteration + 1 << ": " << std::showpos << std::fixed << std::setprecision(3)
+                   << result << std::noshowpos;
+
+         for (size_t i = 0; i < Weights::size(); ++i)
+         {
+            double gradient = result / (2.0 * c * delta[i]);
+            weights[i] = static_cast<float>(std::max(0.0, weights[i] + a * gradient * defaults[i]));
+
+            std::cout << "  " << Weights::getName(i) << '=' << weights[i];
+         }
+         std::cout << std::endl;
+
+         saveTuningCheckpoint(db, iteration + 1, seed, result, weights);
+      }
+   }
+   catch (const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
+
+int runApp(int argc, char** argv)
+{
+   if (argc < 2)
+   {
+      std::cerr << "No database file specified!" << std::endl;
+      return -1;
+   }
+   else if (argc < 3)
+   {
+      std::cerr << "No tileset specified!" << std::endl;
+      return -1;
+   }
+   else if (argc < 4)
+   {
+      std::cerr << "No operation specified!" << std::endl;
+      return -1;
+   }
+
+   std::string operation(argv[3]);
+   std::transform(operation.begin(), operation.end(), operation.begin(), tolower);
+
+   if (operation == "batch")
+      return batch(argc, argv);
+   else if (operation == "tournament")
+      return tournament(argc, argv);
+   else if (operation == "tune")
+      return tune(argc, argv);
+   else
+   {
+      std::cerr << "Unrecognized operation!" << std::endl;
+      return -1;
+   }
+}
+
+int main(int argc, char** argv)
+{
+   int result = runApp(argc, argv);
+
+   if (result < 0)
+      std::cout << std::endl
+                << "Usage: " << std::endl
+                << "   " << (argc > 0 ? argv[0] : "carcassonne-sim") << " <database file> <tileset> <operation> <operation parameters>" << std::endl
+                << std::endl
+                << "Operations:" << std::endl
+                << "   batch <games> <seed> <threads> <player> <player> [<player> ...]" << std::endl
+                << "      Play a batch of games between the same players and report how each seat did." << std::endl
+                << std::endl
+                << "   tournament <results database> <format> <game pairs> <seed> <threads> <player> <player> [<player> ...]" << std::endl
+                << "      Play 2-player matches between the players and rate them.  Each match is played in" << std::endl
+                << "      pairs of games with the same deal and swapped seats, and stops early once an SPRT" << std::endl
+                << "      decides whether the first player is stronger.  format is round-robin (every player" << std::endl
+                << "      plays every other) or gauntlet (the first player plays each of the others)." << std::endl
+                << std::endl
+                << "   tune <config database> <iterations> <game pairs> <seed> <threads>" << std::endl
+                << "      Tune the evaluator weights used by greedy (and SKILL_LEVEL_NORMAL) players with SPSA," << std::endl
+                << "      playing game pairs between two perturbed sets of weights each iteration.  The weights" << std::endl
+                << "      are saved to the config database after every iteration; if it already has a tuning" << std::endl
+                << "      checkpoint, tuning resumes from there (with the checkpoint's seed)." << std::endl
+                << std::endl
+                << "   threads   0 to use every hardware thread" << std::endl
+                << std::endl
+                << "Players:" << std::endl
+                << "   trivial          Place each tile at the first location found (like SKILL_LEVEL_TRIVIAL)." << std::endl
+                << "   random           Play a random legal move." << std::endl
+                << "   greedy           Play the move with the best heuristic evaluation, without searching." << std::endl
+                << "   mcts[:playouts]  Monte Carlo tree search (like SKILL_LEVEL_HARD), 1000 playouts per move by default." << std::endl;
+
+   return result;
+}
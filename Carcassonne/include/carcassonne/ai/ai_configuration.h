@@ -0,0 +1,61 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/ai_configuration.h
+//
+// AiConfiguration is a DAO for accessing the settings of machine players
+// stored in a Carcassonne configuration database.
+
+#ifndef CARCASSONNE_AI_AI_CONFIGURATION_H_
+#define CARCASSONNE_AI_AI_CONFIGURATION_H_
+#include "carcassonne/_carcassonne.h"
+
+#include "carcassonne/ai/endgame_solver.h"
+#include "carcassonne/ai/evaluator.h"
+#include "carcassonne/ai/monte_carlo_search.h"
+#include "carcassonne/db/db.h"
+
+namespace carcassonne {
+namespace ai {
+
+struct AiConfiguration
+{
+public:
+   static AiConfiguration load(db::DB& db);
+
+   AiConfiguration();
+
+   bool save(db::DB& db);
+
+   MonteCarloSearch::Options getSearchOptions() const;
+   EndgameSolver::Options getSolverOptions() const;
+
+   unsigned int turn_time;       // The time (in milliseconds) a machine player can spend thinking each turn.
+   unsigned int threads;         // The number of search threads to use. (0 for one per hardware thread)
+   int endgame_tiles;            // Use the endgame solver when the draw pile has this many tiles or less.
+
+   Evaluator::Weights weights;   // The heuristic used by SKILL_LEVEL_EASY & SKILL_LEVEL_NORMAL players (kept in its own table).
+};
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,108 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/background_search.h
+//
+// Runs a machine player's search on a worker thread, so the render loop
+// keeps running while the machine thinks.  The search works on a snapshot of
+// the game (see GameState(const GameState&, ...)), so the real GameState can
+// be drawn (or changed) while it runs.  The endgame solver is used when few
+// enough tiles remain; otherwise a Monte Carlo search runs until its time
+// budget is used up.
+//
+// Searches can be cancelled from the main thread.  Cancellation is
+// cooperative: the search checks a flag between playouts (or nodes), so it
+// stops within a millisecond or so.
+
+#ifndef CARCASSONNE_AI_BACKGROUND_SEARCH_H_
+#define CARCASSONNE_AI_BACKGROUND_SEARCH_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <SFML/System.hpp>
+
+#include "carcassonne/ai/endgame_solver.h"
+#include "carcassonne/ai/monte_carlo_search.h"
+#include "carcassonne/game_state.h"
+#include "carcassonne/move.h"
+
+namespace carcassonne {
+namespace ai {
+
+class BackgroundSearch
+{
+public:
+   BackgroundSearch(const MonteCarloSearch::Options& search_options, const EndgameSolver::Options& solver_options);
+
+   // Cancels any running search and waits for it to stop.
+   ~BackgroundSearch();
+
+   // Starts searching for the best move for the current player of state,
+   // which must be at the start of a turn.  Any search that is already
+   // running is cancelled first.  seed is used for the snapshot's draw pile
+   // and the search (see GameContext::nextSeed()).
+   void start(const GameState& state, unsigned int seed);
+
+   // Asks the running search to stop.  It will finish soon, without a move.
+   void cancel();
+
+   // True between start() and the end of the search.
+   bool isRunning() const;
+
+   // True if the last search finished without being cancelled; getMove()
+   // is the move it chose.
+   bool hasMove() const;
+   const Move& getMove() const;
+
+   // A description of the last search, for the console.
+   const std::string& getReport() const;
+
+private:
+   void run();  // called on the worker thread
+
+   MonteCarloSearch search_;
+   EndgameSolver solver_;
+
+   // the snapshot the worker thread searches
+   std::vector<std::unique_ptr<Player> > players_;
+   std::vector<Player*> seats_;
+   std::unique_ptr<GameState> state_;
+
+   sf::Thread thread_;
+   mutable sf::Mutex mutex_;  // guards running_, move_, has_move_, report_
+   bool running_;
+   volatile bool cancelled_;
+
+   Move move_;
+   bool has_move_;
+   std::string report_;
+
+   // Disable copy-construction & assignment - do not implement
+   BackgroundSearch(const BackgroundSearch&);
+   void operator=(const BackgroundSearch&);
+};
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/endgame_solver.h
+//
+// Exhaustive search of the last few turns of a game.  Once only a few tiles
+// remain in the draw pile, every order they could be drawn in can be
+// searched: the solver finds the move with the best expected score margin
+// (the current player's score minus the best opponent's score at the end of
+// the game), averaging over the tiles that could be drawn after each move.
+// Opponents are assumed to minimize the margin (in games with more than two
+// players they are treated as a coalition).
+//
+// Margins are clamped to +/- Options::margin_limit.  Knowing the range of
+// every leaf lets chance nodes be pruned (Ballard's *-minimax, "Star1"):
+// once the tiles searched so far prove a move's expectation is outside the
+// alpha-beta window, the remaining tiles aren't searched.  The result is
+// exact for the clamped margin.  Positions reached by different move orders
+// are only searched once (see TranspositionTable), and moves are searched in
+// order of the points they score immediately.
+//
+// When a drawn tile can't be placed anywhere it is discarded and the next
+// tile in the pile is drawn instead.  The solver doesn't branch on that
+// second draw.
+
+#ifndef CARCASSONNE_AI_ENDGAME_SOLVER_H_
+#define CARCASSONNE_AI_ENDGAME_SOLVER_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <memory>
+
+#include "carcassonne/ai/transposition_table.h"
+#include "carcassonne/game_state.h"
+#include "carcassonne/move.h"
+
+namespace carcassonne {
+namespace ai {
+
+class EndgameSolver
+{
+public:
+   struct Options
+   {
+      Options();
+
+      int max_tiles;          // the solver is used once the draw pile has
+                              // at most this many tiles
+      float margin_limit;
+      size_t max_nodes;       // the search is abandoned after visiting this
+                              // many decision nodes; 0 => no limit
+      size_t table_size;      // transposition table entries
+   };
+
+   struct Stats
+   {
+      Stats();
+
+      size_t nodes;           // decision nodes visited
+      size_t table_hits;
+      bool complete;          // false if the search was abandoned or
+                              // cancelled
+   };
+
+   explicit EndgameSolver(const Options& options);
+
+   // True if few enough tiles are left in state's draw pile.
+   bool isApplicable(const GameState& state) const;
+
+   // Finds the best move for the current player of state, which must be at
+   // the start of a turn.  Returns false (and leaves move alone) if the
+   // search visits more than max_nodes decision nodes, or if cancelled is
+   // provided and another thread sets it to true.  value is the expected
+   // (clamped) score margin if move is played.  state is not changed (the
+   // solver searches a copy).
+   bool solve(const GameState& state, Move& move, float& value, const volatile bool* cancelled = nullptr);
+
+   // Statistics from the most recent call to solve().
+   const Stats& getStats() const;
+
+private:
+   enum Bound {
+      BOUND_EXACT,
+      BOUND_LOWER,
+      BOUND_UPPER
+   };
+
+   // The value of the current decision node, within alpha and beta.
+   float search(size_t depth, float alpha, float beta, Move* best_move);
+
+   // The expected value of playing move, averaged over the next tile drawn.
+   float expect(size_t depth, const Move& move, float alpha, float beta);
+
+   // The root player's clamped margin.
+   float evaluate() const;
+
+   // Sorts moves_[depth] so the best immediate scores come first.
+   void orderMoves(size_t depth, size_t move_count, bool maximizing, int first);
+
+   // Packs a value, bound type, and best move into transposition table data
+   static unsigned long long pack(float value, Bound bound, int best);
+   static void unpack(unsigned long long data, float& value, Bound& bound, int& best);
+
+   Options options_;
+   Stats stats_;
+   TranspositionTable table_;
+
+   std::vector<std::unique_ptr<Player> > players_;
+   std::vector<Player*> seats_;
+   std::unique_ptr<GameState> state_;
+   const Player* root_player_;
+   const volatile bool* cancelled_;
+
+   // per-depth scratch space, so nothing is allocated while searching
+   std::vector<std::vector<Move> > moves_;
+   std::vector<std::vector<std::pair<float, size_t> > > order_;
+   std::vector<std::vector<int> > counts_;
+
+   // Disable copy-construction & assignment - do not implement
+   EndgameSolver(const EndgameSolver&);
+   void operator=(const EndgameSolver&);
+};
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
+
+#endif
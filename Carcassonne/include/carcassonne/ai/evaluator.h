@@ -0,0 +1,202 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/evaluator.h
+//
+// A heuristic estimate of what each player's position is worth, for use at
+// the leaves of a search.  Besides the points already scored, each player
+// is credited with the expected value of the regions their followers hold:
+//
+//    - A city or road's chance of being completed is estimated from its open
+//      edges: for each empty location it needs filled, the number of tiles
+//      remaining in the draw pile which would fit there (see
+//      Pile::getFittingCount()).
+//    - A cloister is worth the tiles around it plus the chance of filling
+//      each of its empty neighbors.
+//    - A farm is worth 3 points for each adjacent city, weighted by that
+//      city's chance of completion.
+//
+// A player who has the most followers in a region gets its full value;
+// players with fewer followers get Weights::contested_share of it.  Idle
+// followers are worth Weights::idle_follower each.
+//
+// The size, open locations, and adjacent cities of every region are cached,
+// and update() only recomputes the regions near the last placed tile, so
+// evaluate() just walks the placed followers.  Changes to the cache are
+// journaled, so the Evaluator can follow a search down and back up the tree
+// with getUndoMark() and undo(), the same way as GameState::apply() and
+// GameState::undo().
+
+#ifndef CARCASSONNE_AI_EVALUATOR_H_
+#define CARCASSONNE_AI_EVALUATOR_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+
+#include "carcassonne/db/db.h"
+#include "carcassonne/game_state.h"
+#include "carcassonne/move.h"
+
+namespace carcassonne {
+namespace ai {
+
+class Evaluator
+{
+public:
+   struct Weights
+   {
+      // Loads the weights from a configuration database.  Weights which
+      // aren't in the database (or all of them, if an error occurs) keep
+      // their default values.
+      static Weights load(db::DB& db);
+
+      Weights();
+
+      // Saves the weights to the database, replacing any saved earlier.
+      // Returns false if an error occurred.
+      bool save(db::DB& db) const;
+
+      // The weights as a vector, e.g. for tuning them automatically.
+      static size_t size();
+      static const char* getName(size_t index);
+      float& operator[](size_t index);
+      float operator[](size_t index) const;
+
+      float fit_bias;            // a location which k remaining tiles fit is
+                                 // filled with chance k / (k + fit_bias)
+      float city_completion;     // multiplies the points gained by completing a city
+      float road_extension;      // expected points per open road end
+      float cloister_completion; // multiplies the chance of filling each empty neighbor
+      float farm_city;           // multiplies the 3 points for each adjacent city
+      float contested_share;     // the share of a region's value for a
+                                 // player without the most followers in it
+      float idle_follower;       // value of each follower in hand
+   };
+
+   explicit Evaluator(const Weights& weights = Weights());
+
+   const Weights& getWeights() const;
+   void setWeights(const Weights& weights);
+
+   // Rebuilds the cache for state, which must be at the start of a turn.
+   // Clears the undo journal.
+   void reset(GameState& state);
+
+   // Updates the cache after move has been applied to state (the state
+   // reset() was called on).
+   void update(GameState& state, const Move& move);
+
+   // Returns a mark which can be passed to undo() to return to the current
+   // state.
+   size_t getUndoMark() const;
+
+   // Reverts every update() made since mark was retrieved.  The state must
+   // have been returned to where it was when the mark was taken.
+   void undo(size_t mark);
+
+   // Writes the estimated final score of each player (in seat order) to
+   // values.  Once the game is over, these are just the players' scores.
+   void evaluate(const GameState& state, float* values) const;
+
+   // The estimated final score of the player in seat, minus the best
+   // estimate of the other players.
+   float evaluate(const GameState& state, size_t seat) const;
+
+   // Returns the legal move for the current player of state (which must be
+   // at the start of a turn) with the best evaluation, looking only one move
+   // ahead.  Each move is applied and undone, so state is left as it was.
+   // Calls reset(state).
+   Move getBestMove(GameState& state);
+
+   enum {
+      MAX_PLAYERS = 6,
+      MAX_FOLLOWERS = 7,      // per player
+      MAX_OPEN_LOCATIONS = 8, // per region; regions with more than this are
+                              // treated as never being completed
+      MAX_ADJACENT_CITIES = 8 // per farm
+   };
+
+private:
+   // The cached description of a region, valid for region root nodes.
+   struct Region
+   {
+      Region();
+
+      int type;         // features::Feature::Type
+      int points;       // points if scored now (cloister: tiles around it)
+
+      // constraints (see Board::getConstraints()) of the empty locations
+      // along the region's open edges.  For cloisters, the empty locations
+      // around it.
+      int open_locations;
+      unsigned char constraints[MAX_OPEN_LOCATIONS];
+
+      // region nodes of the adjacent cities, for farms.  Not necessarily
+      // roots.
+      int adjacent_cities;
+      int cities[MAX_ADJACENT_CITIES];
+   };
+
+   Region describe(GameState& state, int root);
+   void findFollowers(GameState& state, int root);
+   int getFollowerSlot(const GameState& state, const Follower& follower) const;
+
+   // The chance that a tile will be placed at an empty location with
+   // constraints (1 if it has no placed neighbors yet).
+   float getFillChance(const Pile& pile, unsigned char constraints) const;
+   float getCompletionChance(const Pile& pile, const Region& region) const;
+   float getValue(const features::RegionStore& regions, const Pile& pile, const Region& region) const;
+
+   // Each entry records one change made by update(): either a region
+   // node's old Region or a follower slot's old node.
+   struct JournalEntry
+   {
+      int node;            // -1 if this is a follower change
+      Region region;
+      int follower;        // -1 if this is a region change
+      int follower_node;
+   };
+
+   Weights weights_;
+
+   std::vector<Region> regions_;    // indexed by region node
+   std::vector<JournalEntry> journal_;
+
+   // a node in the region each placed follower is in (indexed by seat *
+   // MAX_FOLLOWERS + follower index).  Regions only grow, so the node stays
+   // in the follower's region until the follower is removed.
+   int follower_nodes_[MAX_PLAYERS * MAX_FOLLOWERS];
+
+   // reused by getBestMove(), update(), & describe()
+   std::vector<Move> moves_;
+   std::vector<int> roots_;
+   std::vector<int> scratch_;
+   std::vector<glm::ivec2> locations_;
+
+   // Disable copy-construction & assignment - do not implement
+   Evaluator(const Evaluator&);
+   void operator=(const Evaluator&);
+};
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,115 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/monte_carlo_search.h
+//
+// Monte Carlo tree search for the machine player's next move (used for
+// Player::SKILL_LEVEL_HARD).  The tree alternates between decision nodes,
+// where the current player chooses a Move, and chance nodes, where the next
+// tile is drawn from the remaining draw pile.  Each playout shuffles the
+// search's copy of the draw pile, walks down the tree choosing moves by UCB1
+// and following whichever tile was drawn, then finishes the game with random
+// moves.  Each player's reward is their share of the win.
+//
+// The search uses root parallelization: each thread searches its own copy of
+// the GameState with its own tree, and the visit counts of the moves at the
+// root are added together at the end.  The threads don't share anything
+// while searching, so no locks (or virtual loss) are needed and playouts/sec
+// scales with the number of threads.
+
+#ifndef CARCASSONNE_AI_MONTE_CARLO_SEARCH_H_
+#define CARCASSONNE_AI_MONTE_CARLO_SEARCH_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <SFML/System.hpp>
+
+#include "carcassonne/game_state.h"
+#include "carcassonne/move.h"
+
+namespace carcassonne {
+namespace ai {
+
+class MonteCarloSearch
+{
+public:
+   struct Options
+   {
+      Options();
+
+      unsigned int threads;   // 0 => one for each hardware thread
+
+      // The search stops when either budget runs out.  At least one of them
+      // must be set.
+      unsigned int playouts;  // total for all threads; 0 => no limit
+      sf::Time time_limit;    // sf::Time::Zero => no limit
+
+      float exploration;      // UCB1 exploration constant
+      unsigned int seed;
+   };
+
+   struct Stats
+   {
+      Stats();
+
+      unsigned int threads;
+      unsigned int playouts;
+      size_t nodes;           // tree nodes, for all threads
+      sf::Time elapsed;
+
+      float getPlayoutsPerSecond() const;
+   };
+
+   explicit MonteCarloSearch(const Options& options);
+
+   // Returns the best move for the current player of state, which must be
+   // at the start of a turn.  state is not changed (the threads search
+   // copies), but it must not be changed by another thread while search()
+   // is running.  If cancelled is provided, the search stops early (with the
+   // best move found so far) when another thread sets it to true.
+   Move search(const GameState& state, const volatile bool* cancelled = nullptr);
+
+   // Seeds the next search.  Each search() advances the seed, so a
+   // sequence of searches is reproducible from the first seed (as long as
+   // they are limited by playouts, not time).
+   void setSeed(unsigned int seed);
+
+   // Statistics from the most recent call to search().
+   const Stats& getStats() const;
+
+   // The number of threads the hardware can run at once.
+   static unsigned int getHardwareThreads();
+
+private:
+   class Worker;
+
+   Options options_;
+   Stats stats_;
+
+   // Disable copy-construction & assignment - do not implement
+   MonteCarloSearch(const MonteCarloSearch&);
+   void operator=(const MonteCarloSearch&);
+};
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,77 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/transposition_table.h
+//
+// A fixed-size table of search results keyed by GameState::getHash(), so
+// positions reached by different move orders are only searched once.  A
+// table belongs to a single search thread (see EndgameSolver); it must not
+// be shared between threads.  Each entry stores the hash XORed with its
+// data, so an entry whose slot was last written by another position fails
+// validation and is treated as a miss.
+
+#ifndef CARCASSONNE_AI_TRANSPOSITION_TABLE_H_
+#define CARCASSONNE_AI_TRANSPOSITION_TABLE_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <memory>
+
+namespace carcassonne {
+namespace ai {
+
+class TranspositionTable
+{
+public:
+   // size is the number of entries; it is rounded down to a power of 2.
+   explicit TranspositionTable(size_t size);
+
+   size_t size() const;
+
+   // Should not be called while other threads are using the table.
+   void clear();
+
+   // Returns false if there is no entry for hash (it was never stored, or it
+   // has been overwritten by another position).
+   bool probe(unsigned long long hash, unsigned long long& data) const;
+
+   // Always replaces the existing entry in hash's slot.  The meaning of data
+   // is up to the search.
+   void store(unsigned long long hash, unsigned long long data);
+
+private:
+   struct Entry
+   {
+      unsigned long long check;  // hash ^ data
+      unsigned long long data;
+   };
+
+   std::unique_ptr<Entry[]> entries_;
+   size_t mask_;
+
+   // Disable copy-construction & assignment - do not implement
+   TranspositionTable(const TranspositionTable&);
+   void operator=(const TranspositionTable&);
+};
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
+
+#endif
@@ -32,6 +32,7 @@
 #include "carcassonne/gfx/sprite.h"
 #include "carcassonne/gfx/texture_font.h"
 #include "carcassonne/gfx/mesh.h"
+#include "carcassonne/gfx/texture_atlas.h"
 #include "carcassonne/gui/menu.h"
 #include "carcassonne/pile.h"
 
@@ -45,6 +46,7 @@ public:
    AssetManager(Game& game, const std::string& filename);
 
    db::DB& getDB();
+   const gfx::GraphicsConfiguration& getGraphicsConfiguration() const;
 
    void reload();
 
@@ -52,7 +54,13 @@ public:
    gfx::TextureFont* getTextureFont(const std::string& name);
    gfx::Mesh* getMesh(const std::string& name);
    gfx::Sprite getSprite(const std::string& name);
-   Pile getTileSet(const std::string& name);
+   Pile getTileSet(const std::string& name, unsigned int seed);
+
+   // An atlas of the textures of tileset's tiles; layer i is the texture of
+   // the prototype with index i.  Built when the tileset is loaded.  Returns
+   // nullptr if it couldn't be built (tiles can still be drawn with their own
+   // textures).
+   const gfx::TextureAtlas* getTileAtlas(const Tileset& tileset);
 
    std::unique_ptr<gui::Menu> getMenu(const std::string& name);
 
@@ -65,6 +73,8 @@ private:
    std::unordered_map<std::string, std::unique_ptr<gfx::TextureFont> > fonts_;
    std::unordered_map<std::string, std::unique_ptr<gfx::Mesh> > meshes_;
    std::unordered_map<std::string, std::unique_ptr<gui::Menu> > menus_;
+   std::unordered_map<std::string, std::shared_ptr<const Tileset> > tilesets_;
+   std::unordered_map<std::string, std::unique_ptr<gfx::TextureAtlas> > tile_atlases_;
 
    AssetManager(const AssetManager&);
    void operator=(const AssetManager&);
@@ -21,29 +21,39 @@
 // Author: Benjamin Crist
 // File: carcassonne/board.h
 //
-// Represents a map of the game world - by using a std::unordered_map of tiles
+// Represents a map of the game world - tiles are stored in a dense grid of
+// fixed size chunks which are allocated as the board grows.
 
 #ifndef CARCASSONNE_BOARD_H_
 #define CARCASSONNE_BOARD_H_
 #include "carcassonne/_carcassonne.h"
 
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
+#include "carcassonne/move.h"
+#include "carcassonne/player.h"
 #include "carcassonne/tile.h"
+#include "carcassonne/features/region_store.h"
 
 namespace std {
 
 // std::hash specialization for glm::ivec2 to allow use in std::unordered_*
-// containers.
+// containers.  Both coordinates are packed into 64 bits and mixed (using the
+// MurmurHash3 finalizer) so that nearby coordinates don't collide.
 template<>
 struct hash<glm::ivec2>
 {
    size_t operator()(const glm::ivec2& value) const
    {
-      size_t y = std::hash<int>()(value.y);
-      y = (y >> (sizeof(size_t) * 4)) ^ (y << (sizeof(size_t) * 4));
-      return std::hash<int>()(value.x) ^ y;
+      unsigned long long h = (static_cast<unsigned long long>(static_cast<unsigned int>(value.x)) << 32) |
+                              static_cast<unsigned long long>(static_cast<unsigned int>(value.y));
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return static_cast<size_t>(h);
    }
 };
 
@@ -52,50 +62,176 @@ struct hash<glm::ivec2>
 
 namespace carcassonne {
 
-class AssetManager;
-
 class Board
 {
 public:
-   Board(AssetManager& asset_mgr);
+   Board();
 
    glm::ivec2 getCoordinates(const glm::vec3& position) const;
-   Tile* getTileAt(const glm::ivec2& position) const; // uses board coords
-
-   // If tile is a TYPE_EMPTY_* tile, return false if the position already has
-   // a tile of any kind.
-   // If tile is a TYPE_FLOATING tile, return false if the position does not
-   // currently have a TYPE_EMPTY_PLACEABLE tile.
+   Tile* getTileAt(const glm::ivec2& position) const; // uses board coords; only returns TYPE_PLACED tiles
+
+   // Returns the TYPE_EMPTY_* type of an empty location (a location next to
+   // at least one placed tile).  Returns TYPE_EMPTY_NOT_PLACEABLE for
+   // locations which aren't empty locations.
+   Tile::Type getEmptyType(const glm::ivec2& position) const;
+
+   // Returns the edges required of a tile placed at an empty location, 2
+   // bits per side with SIDE_NORTH in the lowest bits: 0 if there is no
+   // neighbor on that side, otherwise the neighbor's TileEdge::Type + 1.
+   // Returns 0 if position isn't an empty location.  Empty locations with
+   // the same constraints accept the same tiles (see Pile::getFittingCount()).
+   unsigned char getConstraints(const glm::ivec2& position) const;
+
+   // Returns false if tile is not a TYPE_FLOATING tile, or if the position
+   // is not currently TYPE_EMPTY_PLACEABLE.
    bool placeTileAt(const glm::ivec2& position, std::unique_ptr<Tile>&& tile);
 
+   // Removes the most recently placed tile, returning the board (including
+   // the regions of placed features and any points scored since the tile was
+   // placed) to the state it was in before placeTileAt() was called.  The
+   // removed tile is a TYPE_FLOATING tile again.  Returns nullptr if no tiles
+   // have been placed.
+   std::unique_ptr<Tile> undoPlacement();
+
    // called to indicate that a new tile is now being placed.  updates all EMPTY_ tiles types
    bool usingNewTile(const Tile& tile);
 
    // similar to usingNewTile, but assumes that the tile is the same as a previous call to
-   // usingNewTile (but perhaps rotated).  Therefore, EMPTY_NOT_PLACEABLE tiles are not rechecked.
+   // usingNewTile (but perhaps rotated).
    void tileRotated(const Tile& tile);
 
+   // Returns a bitmask of the rotations (bit n set for Tile::Rotation n) in
+   // which tile would fit at position.  Returns 0 if position is not an
+   // empty location.
+   unsigned char getFittingRotations(const glm::ivec2& position, const Tile& tile);
+
    const glm::ivec2* getNextPlaceableLocation();
 
+   // Writes every legal move for player placing tile into moves (at most
+   // max_moves of them) and returns the number of legal moves, which may be
+   // more than max_moves.  Moves are generated for each empty location, in
+   // each rotation where the tile fits: first without a follower, then with
+   // a follower on each feature whose region would not already be occupied.
+   // No memory is allocated.
+   size_t getMoves(const Tile& tile, const Player& player, Move* moves, size_t max_moves);
+
    void scoreAllTiles();
 
-   void draw() const;
-   void drawEmpyTiles() const;
+   // TYPE_PLACED tiles, in the order they were placed.
+   const std::vector<Tile*>& getPlacedTiles() const;
+
+   // Locations of all empty locations.  The order is not significant and
+   // changes as tiles are placed.
+   const std::vector<glm::ivec2>& getEmptyLocations() const;
+
+   // The XOR of the zobrist::tile() keys of all placed tiles.  Updated as
+   // tiles are placed and removed.
+   unsigned long long getHash() const;
+
+   // The regions formed by placed tiles' features, for inspection (e.g. by
+   // ai::Evaluator).  Regions should only be changed by placing tiles.
+   features::RegionStore& getRegions();
+   const features::RegionStore& getRegions() const;
 
 private:
-   int checkTilePlaceable(const glm::ivec2& position, Tile* current, const Tile& tile);
-   Tile* makeEmpty(const glm::ivec2& position);
+   enum {
+      CHUNK_SIZE_BITS = 4,
+      CHUNK_SIZE = 1 << CHUNK_SIZE_BITS,  // chunks are CHUNK_SIZE x CHUNK_SIZE cells
+      CHUNK_MASK = CHUNK_SIZE - 1
+   };
+
+   struct Cell
+   {
+      Cell();
+
+      std::unique_ptr<Tile> tile;   // null unless a tile has been placed here
+      int empty_index;              // index in empty_locations_, or -1
+      int bucket_index;             // index in buckets_[constraints].locations, or -1
 
-   AssetManager& asset_mgr_;
+      // Constraints from placed neighbors (see getConstraints()); the index
+      // of this cell's bucket.
+      unsigned char constraints;
+   };
+
+   // All empty locations with the same constraints.  Whether a tile fits is
+   // only checked once per bucket, not once per location.
+   struct Bucket
+   {
+      // in the same format as Tile::getEdgeSignature().  edge_mask has both
+      // bits set for each constrained side.  A tile fits if
+      // (signature & edge_mask) == required_edges.
+      unsigned char edge_mask;
+      unsigned char required_edges;
+
+      std::vector<glm::ivec2> locations;
+
+      // bitmask of rotations of the memoized tile which fit here
+      unsigned char fitting_rotations;
+      Tile::Type type;  // for the current tile
+   };
+
+   struct Chunk
+   {
+      Cell cells[CHUNK_SIZE * CHUNK_SIZE];
+   };
+
+   // What undoPlacement() needs to know to reverse a call to placeTileAt().
+   struct Placement
+   {
+      glm::ivec2 position;
+      int empty_index;           // the placed location's index in empty_locations_
+      size_t new_empty_begin;    // index of the first empty location created
+                                 // by the placement
+      size_t regions_mark;       // see RegionStore::getUndoMark()
+   };
+
+   // returns nullptr if the chunk containing position hasn't been allocated
+   Chunk* findChunk(const glm::ivec2& position) const;
+   Cell* findCell(const glm::ivec2& position) const;
+   Cell& getCell(const glm::ivec2& position);
+
+   // returns the cell at position + offset.  If it is in the same chunk as
+   // position, no chunk lookup is required.
+   Cell* findNeighbor(const glm::ivec2& position, Chunk& chunk, const glm::ivec2& offset) const;
+
+   // calculates fitting_rotations for each active bucket, unless it has
+   // already been done for the same kind of tile since the last placement.
+   void updateFittingRotations(const Tile& tile);
+   void updateBucketTypes(const Tile& tile);
+
+   // Returns a bitmask (bit n for tile.getFeature(n)) of the features of
+   // tile which would join a region that already has followers if it were
+   // placed in rotation next to neighbors (indexed by Tile::Side).
+   unsigned int getOccupiedFeatures(const Tile& tile, Tile::Rotation rotation, Tile* const neighbors[4]);
+
+   // Returns true if placing a tile at position would complete a cloister
+   // occupied by one of player's followers.  Cloisters are scored as soon
+   // as they are completed, so the follower could be placed again.
+   bool completesCloister(const glm::ivec2& position, Chunk& chunk, const Player& player);
+
+   void addToBucket(const glm::ivec2& position, Cell& cell);
+   void removeFromBucket(Cell& cell);
+   void makeEmpty(const glm::ivec2& position);
 
    // +X - North
    // +Z - East
    // -X - South
    // -Z - West
-   std::unordered_map<glm::ivec2, std::unique_ptr<Tile> > board_;
-   std::unordered_set<glm::ivec2> empty_locations_;
+   std::unordered_map<glm::ivec2, std::unique_ptr<Chunk> > chunks_; // keyed by chunk coords
+   std::vector<glm::ivec2> empty_locations_;
+   std::vector<Tile*> placed_tiles_;
+   std::vector<Placement> placements_; // parallel to placed_tiles_
+   unsigned long long hash_;           // see getHash()
+
+   features::RegionStore regions_;  // the regions formed by placed tiles' features
+
+   size_t next_empty_location_;
+
+   Bucket buckets_[256];                     // indexed by Cell::constraints
+   std::vector<unsigned char> active_buckets_; // buckets with at least one location
 
-   std::unordered_set<glm::ivec2>::iterator next_empty_location_;
+   bool fitting_rotations_valid_;
+   unsigned char fitting_rotations_signature_; // unrotated signature of the memoized tile
 
    // Disable copy-construction & assignment - do not implement
    Board(const Board&);
@@ -29,22 +29,18 @@
 #include "carcassonne/features/feature.h"
 
 namespace carcassonne {
-
-class AssetManager;
-
 namespace features {
 
 class City : public Feature
 {
 public:
-   City(AssetManager& asset_mgr, int id, int pennants, Tile& tile);
-   City(const City& other, Tile& tile);
+   City(const Follower& placeholder, int pennants, Tile& tile);
    virtual ~City();
 
    virtual Type getType() const;
    virtual bool isComplete() const;
    virtual void score();
-   void join(City& other);
+   virtual void addToRegion(RegionStore& regions);
 
 private:
    int pennants_; // the number of pennants present in this city.  Each pennant
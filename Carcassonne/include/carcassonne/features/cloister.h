@@ -35,17 +35,24 @@ namespace features {
 class Cloister : public Feature
 {
 public:
-   Cloister(AssetManager& asset_mgr, int id, Tile& tile);
-   Cloister(const Cloister& other, Tile& tile);
+   Cloister(const Follower& placeholder, Tile& tile);
    virtual ~Cloister();
 
    virtual Type getType() const;
    virtual bool isComplete() const;
    virtual void score();
 
+   // The number of tiles in the cloister's 3x3 area which have been placed
+   // (including its own).  The cloister is complete at 9.
+   size_t getTileCount() const;
+
    void addTile(Tile& tile);
+   void removeTile(Tile& tile);
 
 private:
+   // This cloister's tile and up to 8 tiles which border it.
+   std::vector<Tile*> tiles_;
+
    Cloister(const Cloister&);
    void operator=(const Cloister&);
 };
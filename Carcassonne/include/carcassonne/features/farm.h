@@ -32,9 +32,6 @@
 #include "carcassonne/features/feature.h"
 
 namespace carcassonne {
-
-class AssetManager;
-
 namespace features {
 
 class City;
@@ -42,20 +39,21 @@ class City;
 class Farm : public Feature
 {
 public:
-   Farm(AssetManager& asset_mgr, int id, Tile& tile);
-   Farm(const Farm& other, Tile& tile);
+   Farm(const Follower& placeholder, Tile& tile);
    virtual ~Farm();
 
    virtual Type getType() const;   
    virtual bool isComplete() const;
    virtual void score();
-   void join(Farm& other);
+   virtual void addToRegion(RegionStore& regions);
 
-   void replaceCity(const features::City& old_city, features::City& new_city);
+   // Used while creating tiles to record which cities on the same tile this
+   // farm borders.  Once the tile is placed, adjacent cities are tracked by
+   // the farm's region.
    void addAdjacentCity(features::City& city);
 
 private:
-   std::vector<features::City*> adjacent_cities_;
+   std::vector<features::City*> adjacent_cities_; // on this farm's tile
 
    Farm(const Farm&);
    void operator=(const Farm&);
@@ -27,6 +27,7 @@
 #define CARCASSONNE_FEATURES_FEATURE_H_
 
 #include <vector>
+#include <memory>
 
 #include "carcassonne/follower.h"
 
@@ -34,9 +35,17 @@ namespace carcassonne {
 
 class Tile;
 
+namespace db {
+
+class DB;
+
+} // namespace carcassonne::db
+
 namespace features {
 
-class Feature : public std::enable_shared_from_this<Feature>
+class RegionStore;
+
+class Feature
 {
 public:
 
@@ -47,8 +56,9 @@ public:
       TYPE_CLOISTER = 3
    };
 
-   Feature();
-   Feature(const Feature& other);
+   // placeholder must outlive the feature (it belongs to the tile's
+   // TilePrototype).
+   Feature(const Follower& placeholder, Tile& tile);
    virtual ~Feature(); 
 
    virtual Type getType() const = 0; // returns the type of feature this is.
@@ -68,29 +78,47 @@ public:
    // idle state.
    virtual void score() = 0;
    //returns true if tile has placeholders where followers can be placed
+   //(i.e. no follower inhabits this feature's region yet)
    bool hasPlaceholder() const;
    const Follower* getPlaceholder() const;
-   //draw a placeholder on the tile displaying where a follower is legal
-   void drawPlaceholder() const;
-   //sets the color of the placeholder
-   void setPlaceholderColor(const glm::vec4& color);
    //places placeholder on til in the right postion 
    void placeFollower(Follower& follower, const Tile& relative_to);
-      
+
+   // Called when this feature's tile is placed on the board.  The feature
+   // becomes a new region in regions, containing only this feature.
+   virtual void addToRegion(RegionStore& regions);
+
+   // Called when this feature's tile is removed from the board (see
+   // Board::undoPlacement()), after the RegionStore has been rolled back.
+   void removeFromRegion();
+
+   // merges this feature's region with another feature's region (due to a
+   // tile being placed connecting them).
+   void join(Feature& other);
+
+   // called when a tile is placed against one of the edges this feature
+   // touches.
+   void closeEdge();
+
+   int getRegion() const;
+   Tile& getTile() const;
 
 protected:
-   // The tiles which contain at least a part of this feature.  For cloisters,
-   // this also contains up to 8 tiles which border the cloister.
-   std::vector<Tile*> tiles_;
+   // Awards points to the player(s) with the most followers in this
+   // feature's region and returns those followers to idle state.
+   void awardPoints(int points);
 
-   // A follower not owned by any player indicating the location where a
-   // player can deploy a follower.  If this feature already has one or more
-   // followers, this should be reset to null.
-   std::unique_ptr<Follower> follower_placeholder_;  
+   // The tile which this feature is on.
+   Tile* tile_;
+
+   // The regions this feature belongs to and this feature's node in it.
+   // regions_ is null until the feature's tile has been placed.
+   RegionStore* regions_;
+   int region_;
 
-   // The followers that currently inhabit this feature.  (Does not include
-   // placeholder followers)
-   std::vector<Follower*> followers_;  
+   // A follower not owned by any player indicating the location where a
+   // player can deploy a follower.
+   const Follower* follower_placeholder_;  
 
    // Disable assignment - do not implement
    void operator=(const Feature&);
@@ -0,0 +1,80 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/features/feature_pool.h
+//
+// Owns the features of every tile drawn from a pile.  Each type of feature
+// is stored contiguously in its own Pool, and features are referred to by
+// 32-bit handles: the feature's Feature::Type in the top 2 bits and its
+// index in that type's pool in the rest.  All the features from one game are
+// destroyed together when the pool is destroyed.  A destroyed Tile's features
+// are never released, so Pile keeps tiles which go back in the pile for
+// reuse instead of destroying them (see Pile::clearReturned()).
+
+#ifndef CARCASSONNE_FEATURES_FEATURE_POOL_H_
+#define CARCASSONNE_FEATURES_FEATURE_POOL_H_
+#include "carcassonne/_carcassonne.h"
+
+#include "carcassonne/pool.h"
+#include "carcassonne/features/city.h"
+#include "carcassonne/features/cloister.h"
+#include "carcassonne/features/farm.h"
+#include "carcassonne/features/road.h"
+
+namespace carcassonne {
+namespace features {
+
+typedef unsigned int FeatureHandle;
+
+class FeaturePool
+{
+public:
+   enum {
+      HANDLE_TYPE_SHIFT = 30,
+      HANDLE_INDEX_MASK = (1 << HANDLE_TYPE_SHIFT) - 1
+   };
+
+   FeaturePool();
+
+   FeatureHandle createCity(const Follower& placeholder, int pennants, Tile& tile);
+   FeatureHandle createRoad(const Follower& placeholder, Tile& tile);
+   FeatureHandle createFarm(const Follower& placeholder, Tile& tile);
+   FeatureHandle createCloister(const Follower& placeholder, Tile& tile);
+
+   Feature& get(FeatureHandle handle) const;
+
+   static Feature::Type getType(FeatureHandle handle);
+
+private:
+   Pool<City> cities_;
+   Pool<Road> roads_;
+   Pool<Farm> farms_;
+   Pool<Cloister> cloisters_;
+
+   // Disable copy-construction & assignment - do not implement
+   FeaturePool(const FeaturePool&);
+   void operator=(const FeaturePool&);
+};
+
+} // namespace carcassonne::features
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,175 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/features/region_store.h
+//
+// A disjoint-set (union-find) forest of feature regions.  When tiles are
+// connected, the features on either side of the shared edge become part of
+// the same region (e.g. one city spanning several tiles).  Each feature on a
+// placed tile is a node, and the data describing a whole region (its size,
+// pennants, open edges, followers, adjacent cities) is kept by the region's
+// root node.
+//
+// Every change is recorded in an undo journal, so the store can be rolled
+// back to any earlier state with undo() (see GameState::undo()).
+
+#ifndef CARCASSONNE_FEATURES_REGION_STORE_H_
+#define CARCASSONNE_FEATURES_REGION_STORE_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <utility>
+
+#include "carcassonne/follower.h"
+
+namespace carcassonne {
+
+namespace features {
+
+class Feature;
+
+class RegionStore
+{
+public:
+   RegionStore();
+
+   // Adds a new region containing only feature.  open_edges is the number
+   // of tile edges the feature touches (only tracked for cities and roads).
+   // Returns the new node's id.
+   int add(Feature& feature, int pennants, int open_edges);
+
+   // Returns the id of the root node of the region containing node.
+   int find(int node);
+
+   // Like find(), but without path compression, so it can be used on a
+   // const RegionStore and doesn't add to the undo journal.
+   int getRoot(int node) const;
+
+   // The number of nodes that have been added (node ids are 0 to
+   // size() - 1).
+   size_t size() const;
+
+   // Merges the regions containing a and b (union by size).  Returns the
+   // root of the merged region.
+   int join(int a, int b);
+
+   Feature& getFeature(int node) const;
+
+   // The nodes of each region form a ring; starting at any node and
+   // following getNext() visits every feature in the region.
+   int getNext(int node) const;
+
+   // The number of features in the region.  Since each feature is only on
+   // one tile, this is the number of tiles covered by the region (a tile
+   // counts once per separate piece of the region on it).
+   int getTileCount(int node);
+   int getPennants(int node);
+
+   // The number of tile edges covered by the region which do not yet have a
+   // neighboring tile.  Cities and roads are complete when this reaches 0.
+   int getOpenEdges(int node);
+   void closeEdge(int node);
+
+   // The followers that currently inhabit the region.  addFollower() should
+   // be called before the follower is moved onto the feature, so undo() can
+   // return it to its previous state.
+   const std::vector<Follower*>& getFollowers(int node);
+   void addFollower(int node, Follower& follower);
+
+   // Awards points to the player(s) with the most followers in the region
+   // and returns those followers to idle state.
+   void score(int node, int points);
+
+   // Farm regions keep track of the cities they border.
+   void addAdjacentCity(int farm_node, int city_node);
+
+   // Gets the roots of the city regions adjacent to a farm region, without
+   // duplicates.
+   void getAdjacentCities(int farm_node, std::vector<int>& cities);
+
+   // Returns a mark which can be passed to undo() to return to the current
+   // state.
+   size_t getUndoMark() const;
+
+   // Reverts every change made since mark was retrieved.  Changes must be
+   // undone in the reverse of the order they were made.
+   void undo(size_t mark);
+
+private:
+   struct JournalEntry
+   {
+      enum Type {
+         TYPE_ADD,            // a node was added
+         TYPE_PARENT,         // node's parent was a (path compression)
+         TYPE_JOIN,           // root node was made a child of a; a's
+                              // followers & adjacent cities had b & c entries
+         TYPE_CLOSE_EDGE,     // root node's open_edges was decremented
+         TYPE_ADD_FOLLOWER,   // a follower (whose previous state is
+                              // saved_followers_[a]) was added to root node
+         TYPE_ADD_CITY,       // an adjacent city was added to root node
+         TYPE_SCORE           // root node's b followers (saved in
+                              // saved_followers_ starting at a) were
+                              // awarded c points
+      } type;
+
+      int node;
+      int a;
+      int b;
+      int c;
+   };
+
+   void record(JournalEntry::Type type, int node, int a = 0, int b = 0, int c = 0);
+
+   // Adds points to (or subtracts from) the score of each player with the
+   // most followers in followers.
+   static void awardPoints(const std::vector<Follower*>& followers, int points);
+
+   struct Node
+   {
+      int parent;
+      int next;         // next node in this region's ring
+      Feature* feature;
+
+      // only valid for root nodes:
+      int size;
+      int pennants;
+      int open_edges;
+      std::vector<Follower*> followers;
+      std::vector<int> adjacent_cities; // not necessarily roots
+   };
+
+   std::vector<Node> nodes_;
+
+   std::vector<JournalEntry> journal_;
+
+   // each follower added to or removed from a region and its state before
+   // the change, so it can be restored by undo().
+   std::vector<std::pair<Follower*, Follower> > saved_followers_;
+
+   // Disable copy-construction & assignment - do not implement
+   RegionStore(const RegionStore&);
+   void operator=(const RegionStore&);
+};
+
+} // namespace carcassonne::features
+} // namespace carcassonne
+
+#endif
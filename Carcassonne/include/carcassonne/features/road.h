@@ -29,22 +29,18 @@
 #include "carcassonne/features/feature.h"
 
 namespace carcassonne {
-
-class AssetManager;
-
 namespace features {
 
 class Road : public Feature
 {
 public:
-   Road(AssetManager& asset_mgr, int id, Tile& tile);
-   Road(const Road& other, Tile& tile);
+   Road(const Follower& placeholder, Tile& tile);
    virtual ~Road();
 
    virtual Type getType() const;
    virtual bool isComplete() const;
    virtual void score();
-   void join(Road& other);
+   virtual void addToRegion(RegionStore& regions);
 
 private:
    Road(const Road&);
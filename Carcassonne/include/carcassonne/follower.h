@@ -32,15 +32,8 @@
 namespace carcassonne {
 
 class Player;
-class AssetManager;
 class Tile;
 
-namespace gfx {
-
-class Mesh;
-
-} // namespace carcassonne::gfx
-
 class Follower
 {
 public:
@@ -48,8 +41,9 @@ public:
    Follower(const Follower& other);
    void operator=(const Follower& other);
 
-   Follower(AssetManager& asset_mgr, int id);
-   Follower(AssetManager& asset_mgr, Player& owner);   
+   // create a placeholder follower (no owner)
+   Follower(const glm::vec3& position, bool farming, float rotation);
+   explicit Follower(Player& owner);
 
    Player* getOwner() const;
    bool isIdle() const;
@@ -64,22 +58,12 @@ public:
    void setPosition(const glm::vec3& position);
    const glm::vec3& getPosition() const;
 
-   void setColor(const glm::vec4& color);
-
-   
-   // called by Player::draw() if the follower is idle, or Tile::draw() (after
-   // setting up the tile's local transform matrix) if the follower is not idle
-   // or has no owner player.
-   void draw() const;
+   bool isFarming() const;
+   float getRotation() const;
 
 private:
-   void calculateFarmingTransform();
-
    Player* owner_;
 
-   gfx::Mesh* mesh_;  // the mesh used to render the follower
-   glm::vec4 color_;
-
    bool idle_;       // false if this follower is currently in use.
    bool floating_;   // true if this follower is currently being placed.
    
@@ -87,7 +71,6 @@ private:
    glm::vec3 position_; // position of follower. When idle, position is absolute in the HUD camera's world space.
                         // When follower is not idle, position is relative to the tile it is placed on.
    bool farming_; // followers are rendered laying down when farming.  Ignored when idle
-   glm::mat4 farming_transform_; // transforms a standing follower to a laying down follower
    float rotation_;  // rotation around y-axis.  Ignored when idle
 };
 
@@ -32,6 +32,7 @@
 #include <SFML/System.hpp>
 #include <SFML/Window.hpp>
 
+#include "carcassonne/ai/ai_configuration.h"
 #include "carcassonne/db/db.h"
 #include "carcassonne/gfx/graphics_configuration.h"
 #include "carcassonne/gfx/ortho_camera.h"
@@ -51,6 +52,7 @@ public:
 
    db::DB& getConfigurationDB();
    const gfx::GraphicsConfiguration& getGraphicsConfiguration() const;
+   const ai::AiConfiguration& getAiConfiguration() const;
    AssetManager& getAssetManager();
    Scenario* getScenario() const;
    
@@ -90,6 +92,7 @@ private:
 
    db::DB config_db_;
    gfx::GraphicsConfiguration gfx_cfg_;
+   ai::AiConfiguration ai_cfg_;
    sf::Window window_;
    AssetManager assets_;
    
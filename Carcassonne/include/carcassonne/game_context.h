@@ -0,0 +1,90 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/game_context.h
+//
+// Everything a single game owns that used to be shared between games: the
+// players sitting at the table and the PRNG that every other random choice
+// in the game (dealing the draw pile, seeding AI searches) is drawn from.
+// The Players owned by Game are just profiles (name, win/loss record); each
+// game plays with its own copies, and the results are recorded back to the
+// profiles when it ends.
+//
+// Games with different contexts don't share anything mutable, so they can be
+// played on separate threads, and a game played from the same seed with the
+// same (deterministic) players plays out identically.
+
+#ifndef CARCASSONNE_GAME_CONTEXT_H_
+#define CARCASSONNE_GAME_CONTEXT_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "carcassonne/player.h"
+
+namespace carcassonne {
+
+class GameContext
+{
+public:
+   explicit GameContext(unsigned int seed);
+
+   unsigned int getSeed() const;
+
+   // Returns a new seed for one of the game's random choices.  Seeds are
+   // drawn in order, so they are the same each time the game is played
+   // from the same seed.
+   unsigned int nextSeed();
+
+   // Adds a seat at the table for profile, copying its name, human flag,
+   // skill level, and color.  recordResults() updates profile.
+   Player& addPlayer(Player& profile);
+
+   // Adds a seat that doesn't belong to any profile (e.g. for simulations).
+   Player& addPlayer(const std::string& name, bool human, Player::SkillLevel skill_level, const glm::vec4& color);
+
+   const std::vector<Player*>& getPlayers() const;
+
+   // Records a win for each player with the highest score (and a loss for
+   // everyone else) in each seat's profile, once the game is over.  Only
+   // the first call does anything.
+   void recordResults();
+
+private:
+   unsigned int seed_;
+   std::mt19937 prng_; // PRNG => psudo-random number generator
+
+   std::vector<std::unique_ptr<Player> > seats_;
+   std::vector<Player*> players_;   // seats_, in turn order
+   std::vector<Player*> profiles_;  // nullptr for seats without a profile
+   bool results_recorded_;
+
+   // Disable copy-construction & assignment - do not implement
+   GameContext(const GameContext&);
+   void operator=(const GameContext&);
+};
+
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,190 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/game_state.h
+//
+// The rules of a single match: the board, the draw pile, the players, and
+// the turn state machine which moves between tile placement, follower
+// placement, and scoring.  GameState has no dependencies on OpenGL, SFML, or
+// the AssetManager, so it can be used to run games without a window (e.g.
+// for AI players or simulations).  Scenario is a rendering & input layer on
+// top of a GameState.
+//
+// Every turn can be undone, returning the game to exactly the state it was in
+// at the start of the turn, so AI players can search ahead by applying and
+// undoing moves on the real game state.
+
+#ifndef CARCASSONNE_GAME_STATE_H_
+#define CARCASSONNE_GAME_STATE_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <memory>
+
+#include "carcassonne/board.h"
+#include "carcassonne/move.h"
+#include "carcassonne/pile.h"
+#include "carcassonne/player.h"
+
+namespace carcassonne {
+
+class GameState
+{
+public:
+   // Places starting_tile at the origin and starts the first player's turn.
+   GameState(const std::vector<Player*>& players, Pile&& draw_pile, std::unique_ptr<Tile>&& starting_tile);
+
+   // Creates a copy of other, played by players (there must be as many as
+   // other has; newScenario() is called on each of them), by replaying each
+   // of other's turns.  The tiles remaining in other's draw pile are shuffled
+   // using seed, so the copy doesn't know the order other will draw them in.
+   // other must be at the start of a turn.  Copies can be made concurrently,
+   // as long as other isn't being changed.
+   GameState(const GameState& other, const std::vector<Player*>& players, unsigned int seed);
+
+   Board& getBoard();
+   const Board& getBoard() const;
+   const Pile& getDrawPile() const;
+   const std::vector<Player*>& getPlayers() const;
+
+   Player& getCurrentPlayer();
+   const Player& getCurrentPlayer() const;
+
+   // The tile that is currently being played, or nullptr if the current
+   // player is placing a follower or the game is over.
+   Tile* getCurrentTile() const;
+
+   // The tile that was placed this turn, if the current player is placing
+   // a follower on it.
+   Tile* getLastPlacedTile() const;
+
+   // The follower that is currently being placed, if any.
+   Follower* getCurrentFollower() const;
+
+   // The features of the last placed tile where the current follower can
+   // be placed.
+   const std::vector<features::Feature*>& getFollowerPlaceholders() const;
+
+   bool isGameOver() const;
+
+   // The number of tiles remaining in the draw pile which would fit at
+   // position in at least one rotation, or 0 if position isn't an empty
+   // location.  Divided by getDrawPile().size(), this is the chance that the
+   // next tile drawn could be placed there.
+   int getFittingTileCount(const glm::ivec2& position) const;
+
+   // A 64-bit Zobrist hash of the placed tiles, the tiles remaining in the
+   // draw pile, the current tile & player, each player's score, and the
+   // followers on the board (see carcassonne/zobrist.h).  Positions reached
+   // by different move orders have the same hash.  Only meaningful at the
+   // start of a turn.
+   unsigned long long getHash() const;
+
+   // Rotates the current tile and updates the board's empty tile types.
+   void rotateTileClockwise();
+   void rotateTileCounterclockwise();
+
+   const glm::ivec2* getNextPlaceableLocation();
+
+   // Writes the legal moves for the current player into moves (at most
+   // max_moves of them) and returns the number of legal moves.  Returns 0
+   // if the current player isn't at the start of a turn.  See
+   // Board::getMoves().
+   size_t getMoves(Move* moves, size_t max_moves);
+
+   // Places the current tile.  Returns false if it can't be placed there.
+   // If the current player has an idle follower and the tile has at least one
+   // feature where it could be placed, the follower becomes the current
+   // follower and the turn continues.  Otherwise the turn is ended.
+   bool placeTile(const glm::ivec2& board_coords);
+
+   // Returns the follower placeholder feature closest to world_coords.  If
+   // limit_distance is true, only placeholders within 1 unit are considered.
+   features::Feature* getNearestPlaceholder(const glm::vec3& world_coords, bool limit_distance) const;
+
+   // Places the current follower on feature (which should be one of
+   // getFollowerPlaceholders()) and ends the turn.  If feature is nullptr the
+   // follower is returned to its owner.
+   void placeFollower(features::Feature* feature);
+
+   void endTurn();
+
+   // Plays a complete turn for the current player: rotates the current tile,
+   // places it, places a follower (if the move has one), and ends the turn.
+   // Returns false without changing anything if the tile doesn't fit at
+   // move.position in that rotation or the follower can't be placed on that
+   // feature.  Can only be used at the start of a turn.
+   bool apply(const Move& move);
+
+   // Reverts the most recent turn, whether it was played with apply() or
+   // placeTile() & placeFollower().  The tile that was placed becomes the
+   // current tile again, and the draw pile, followers, and scores are
+   // restored.  Returns false if there are
+   // no turns to undo or the current player is placing a follower.
+   bool undo();
+
+   // Shuffles the tiles remaining in the draw pile.  AI players shuffle
+   // their copy of the game before each look ahead, to sample different
+   // orders the tiles might be drawn in.
+   void shuffleDrawPile();
+
+   // Moves a tile of prototype to the top of the draw pile, so it is drawn at
+   // the end of the current turn.  Lets AI players choose which tile is drawn
+   // when they look ahead.  Returns false if there are none in the pile.
+   bool setNextTile(size_t prototype);
+
+private:
+   // What undo() needs to know to reverse a turn.  Changes to the board and
+   // to regions (including scoring) are journaled by the Board itself.
+   struct Turn
+   {
+      std::vector<Player*>::iterator player;
+      Move move;                 // the move that was played (see GameState(const GameState&, ...))
+      Tile::Rotation rotation;   // the current tile's rotation before the turn
+      Follower* follower;        // the player's idle follower, if they had one
+      size_t discarded;          // the number of unplaceable tiles discarded
+                                 // when drawing the next tile
+   };
+
+   bool game_over_;
+
+   Board board_;
+   Pile draw_pile_;
+   std::vector<Player*> players_;
+
+   std::vector<Player*>::iterator current_player_; // iterator to the player
+                                                   // whose turn it is
+   std::unique_ptr<Tile> current_tile_; // the tile that is currently being played
+   Tile* last_placed_tile_;
+   Follower* current_follower_;
+   std::vector<features::Feature*> follower_placeholders_;
+
+   std::vector<Turn> turns_;
+   std::vector<std::unique_ptr<Tile> > discarded_; // see Turn::discarded
+
+   // Disable copy-construction & assignment - do not implement
+   GameState(const GameState&);
+   void operator=(const GameState&);
+};
+
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,108 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/batch.h
+//
+// A batch holds many copies (instances) of meshes, each with its own
+// transform and color, baked into one vertex buffer so they can all be drawn
+// with a single call.  Instances can only be added or cleared, so it suits
+// things which change rarely, like the tiles placed on the board.
+
+#ifndef CARCASSONNE_GFX_BATCH_H_
+#define CARCASSONNE_GFX_BATCH_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+
+#include "carcassonne/gfx/graphics_configuration.h"
+#include "carcassonne/gfx/mesh.h"
+
+namespace carcassonne {
+namespace gfx {
+
+class Batch
+{
+public:
+   explicit Batch(const GraphicsConfiguration& gfx_cfg);
+   ~Batch();
+
+   // Removes all instances.
+   void clear();
+
+   // Adds an instance of mesh's triangles, transformed by transform and
+   // colored color.
+   void add(const Mesh& mesh, const glm::mat4& transform, const glm::vec4& color);
+
+   // Adds an instance whose texture is one layer of an atlas.  texture_rect
+   // is the layer's rectangle (see TextureAtlas::getLayerRect()); the mesh's
+   // texture coordinates are mapped into it.
+   void add(const Mesh& mesh, const glm::mat4& transform, const glm::vec4& color, const glm::vec4& texture_rect);
+
+   size_t getInstanceCount() const;
+
+   // The corners of a box containing every instance.  Meaningless if there
+   // are no instances.
+   const glm::vec3& getMin() const;
+   const glm::vec3& getMax() const;
+
+   // Uses whatever texture settings are currently set.  Instances added since
+   // the last draw are uploaded first.
+   // make sure depth buffer writing and GL_DEPTH_TEST are enabled before drawing!
+   void draw() const;
+
+private:
+   struct Vertex
+   {
+      glm::vec3 texture_coord;
+      glm::vec4 color;
+      glm::vec3 normal;
+      glm::vec3 position;
+   };
+
+   bool useBuffers() const;
+   void upload() const;
+
+   const GraphicsConfiguration& gfx_cfg_;
+
+   std::vector<Vertex> vertices_;
+   std::vector<GLuint> indices_;
+   size_t instances_;
+   glm::vec3 min_;
+   glm::vec3 max_;
+
+   // Buffer objects are shared between all of SFML's contexts, so unlike
+   // vertex array objects they survive the window being recreated.
+   mutable GLuint vertex_buffer_id_;
+   mutable GLuint index_buffer_id_;
+   mutable size_t vertex_capacity_;    // the sizes of the buffers, in elements
+   mutable size_t index_capacity_;
+   mutable size_t uploaded_vertices_;  // how much of vertices_ & indices_ is
+   mutable size_t uploaded_indices_;   // already in the buffers
+
+   // Disable copy-construction & assignment - do not implement
+   Batch(const Batch&);
+   void operator=(const Batch&);
+};
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,180 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/board_renderer.h
+//
+// Draws the objects from the rules core (tiles, followers, and follower
+// placeholders) using meshes and textures from the AssetManager.  The rules
+// objects themselves know nothing about OpenGL.
+//
+// Placed tiles, placed followers, and follower placeholders are kept in
+// Batches, which are only changed by update(), so each frame draws them with
+// one call per texture instead of one per object.  Tiles use their tileset's
+// TextureAtlas when it is available, so they only need one call.
+//
+// The batches are split into square chunks of the board, so chunks which
+// are outside the camera's view frustum can be skipped.  Tiles never move
+// once they are placed, so a chunk's tiles are baked into its batches when
+// they land in it, and the chunk is only rebuilt if one is taken away.
+
+#ifndef CARCASSONNE_GFX_BOARD_RENDERER_H_
+#define CARCASSONNE_GFX_BOARD_RENDERER_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <memory>
+#include <map>
+#include <unordered_map>
+
+#include "carcassonne/board.h"
+#include "carcassonne/game_state.h"
+#include "carcassonne/player.h"
+#include "carcassonne/gfx/batch.h"
+#include "carcassonne/gfx/frustum.h"
+#include "carcassonne/gfx/mesh.h"
+#include "carcassonne/gfx/texture.h"
+#include "carcassonne/gfx/texture_atlas.h"
+
+namespace carcassonne {
+
+class AssetManager;
+
+namespace gfx {
+
+class BoardRenderer
+{
+public:
+   // What was drawn and what was culled (for being outside the frustum)
+   // since the start of the frame.  drawBoard() starts a new frame.
+   struct Stats
+   {
+      Stats();
+
+      size_t chunks_drawn;
+      size_t chunks_culled;
+      size_t tiles_drawn;
+      size_t tiles_culled;
+      size_t followers_drawn;
+      size_t followers_culled;
+      size_t empty_tiles_drawn;
+      size_t empty_tiles_culled;
+   };
+
+   explicit BoardRenderer(AssetManager& asset_mgr);
+
+   // Brings the batches up to date with state.  Tiles placed since the last
+   // update are appended to their chunks' batches; the follower and
+   // placeholder batches are refilled.  Call whenever state moves to a new
+   // phase of a turn, not every frame.
+   void update(const GameState& state);
+
+   // draws all placed tiles (as of the last update) in chunks which
+   // intersect frustum
+   void drawBoard(const Frustum& frustum) const;
+
+   // draws a translucent tile at each empty location inside frustum, colored
+   // to indicate whether the current tile can be placed there.
+   void drawEmptyTiles(const Board& board, const Frustum& frustum) const;
+
+   void drawTile(const Tile& tile) const;
+
+   // draws placeholder followers for the features of the last placed tile
+   // where the current follower can be placed (as of the last update)
+   void drawPlaceholders() const;
+
+   void drawFollower(const Follower& follower) const;
+
+   // draws every player's placed followers (as of the last update) in chunks
+   // which intersect frustum
+   void drawPlacedFollowers(const Frustum& frustum) const;
+
+   // draws the idle followers of a player in the HUD
+   void drawIdleFollowers(const Player& player) const;
+
+   const Stats& getStats() const;
+
+private:
+   enum { CHUNK_SIZE = 8 };   // the width & depth of a chunk, in tiles
+
+   typedef std::map<const Texture*, std::unique_ptr<Batch> > BatchMap;
+
+   // The placed tiles and followers in one CHUNK_SIZE x CHUNK_SIZE square of
+   // the board.
+   struct Chunk
+   {
+      explicit Chunk(const GraphicsConfiguration& gfx_cfg);
+
+      BatchMap tiles;      // by texture
+      Batch followers;
+      std::vector<const Tile*> placed_tiles; // the tiles in tiles, in the
+                                             // order they were placed
+      bool dirty;          // tiles needs to be rebuilt from placed_tiles
+   };
+
+   // What a tile looked like when it was batched.  Undone turns put the
+   // same Tile object back in the pile, so it may be placed again somewhere
+   // else.
+   struct BatchedTile
+   {
+      const Tile* tile;
+      glm::vec3 position;
+      Tile::Rotation rotation;
+   };
+
+   typedef std::map<std::pair<int, int>, std::unique_ptr<Chunk> > ChunkMap;
+
+   Chunk& getChunk(const glm::vec3& position);
+   void addTile(Chunk& chunk, const Tile& tile);
+
+   void drawFollower(const Follower& follower, const glm::vec4& color) const;
+   void drawFollowerBatch(const Batch& batch) const;
+   glm::mat4 getTileTransform(const Tile& tile) const;
+   glm::mat4 getFollowerTransform(const Follower& follower) const;
+   Texture* getTexture(const std::string& name) const;
+
+   AssetManager& asset_mgr_;
+
+   Mesh* tile_mesh_;
+   Mesh* follower_mesh_;
+   glm::mat4 farming_transform_;
+
+   mutable std::unordered_map<std::string, Texture*> textures_;
+
+   glm::vec3 tile_extents_;   // half the size of tile_mesh_'s bounding box
+
+   const TextureAtlas* tile_atlas_;
+
+   ChunkMap chunks_;
+   std::vector<BatchedTile> batched_tiles_;  // the tiles in chunks_, in the
+                                             // order they were placed
+   Batch placeholder_batch_;
+
+   mutable Stats stats_;
+
+   // Disable copy-construction & assignment - do not implement
+   BoardRenderer(const BoardRenderer&);
+   void operator=(const BoardRenderer&);
+};
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,53 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/frustum.h
+//
+// The six clipping planes of a camera's view volume, in world space, for
+// skipping things which are entirely off screen.
+
+#ifndef CARCASSONNE_GFX_FRUSTUM_H_
+#define CARCASSONNE_GFX_FRUSTUM_H_
+#include "carcassonne/_carcassonne.h"
+
+namespace carcassonne {
+namespace gfx {
+
+class Frustum
+{
+public:
+   // Extracts the planes from a view-projection matrix (see
+   // Camera::getViewProjection()).
+   explicit Frustum(const glm::mat4& view_projection);
+
+   // Returns false if the axis-aligned box from min to max is entirely
+   // outside the frustum.  Boxes near a corner of the frustum may be
+   // reported as intersecting even if they don't.
+   bool intersects(const glm::vec3& min, const glm::vec3& max) const;
+
+private:
+   glm::vec4 planes_[6];   // (normal, distance), with normals facing in
+};
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
+
+#endif
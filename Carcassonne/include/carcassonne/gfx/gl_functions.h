@@ -0,0 +1,98 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/gl_functions.h
+//
+// OpenGL entry points newer than OpenGL 1.1, which the system's gl.h doesn't
+// declare (at least on Windows), loaded at runtime.  Only the functions the
+// renderer actually uses are here.
+
+#ifndef CARCASSONNE_GFX_GL_FUNCTIONS_H_
+#define CARCASSONNE_GFX_GL_FUNCTIONS_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <cstddef>
+#include <SFML/OpenGL.hpp>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+
+namespace carcassonne {
+namespace gfx {
+namespace gl {
+
+typedef std::ptrdiff_t sizeiptr;
+typedef std::ptrdiff_t intptr;
+
+// Buffer objects (OpenGL 1.5)
+typedef void (APIENTRY* GenBuffersProc)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRY* DeleteBuffersProc)(GLsizei n, const GLuint* buffers);
+typedef void (APIENTRY* BindBufferProc)(GLenum target, GLuint buffer);
+typedef void (APIENTRY* BufferDataProc)(GLenum target, sizeiptr size, const GLvoid* data, GLenum usage);
+typedef void (APIENTRY* BufferSubDataProc)(GLenum target, intptr offset, sizeiptr size, const GLvoid* data);
+
+// Vertex array objects (OpenGL 3.0)
+typedef void (APIENTRY* GenVertexArraysProc)(GLsizei n, GLuint* arrays);
+typedef void (APIENTRY* DeleteVertexArraysProc)(GLsizei n, const GLuint* arrays);
+typedef void (APIENTRY* BindVertexArrayProc)(GLuint array);
+
+extern GenBuffersProc genBuffers;
+extern DeleteBuffersProc deleteBuffers;
+extern BindBufferProc bindBuffer;
+extern BufferDataProc bufferData;
+extern BufferSubDataProc bufferSubData;
+
+extern GenVertexArraysProc genVertexArrays;
+extern DeleteVertexArraysProc deleteVertexArrays;
+extern BindVertexArrayProc bindVertexArray;
+
+// Loads the buffer object functions from the current context.  Returns false
+// (and leaves them null) if the driver doesn't provide all of them.
+bool loadBufferObjects();
+
+// Loads the vertex array object functions from the current context.  Returns
+// false (and leaves them null) if the driver doesn't provide all of them.
+bool loadVertexArrays();
+
+// Returns true if the version of the current context (as reported by
+// GraphicsConfiguration) is at least major.minor.
+bool isVersionAtLeast(unsigned int version_major, unsigned int version_minor,
+                      unsigned int major, unsigned int minor);
+
+} // namespace carcassonne::gfx::gl
+} // namespace carcassonne::gfx
+} // namespace carcassonne
+
+#endif
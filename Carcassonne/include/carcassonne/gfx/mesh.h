@@ -23,6 +23,10 @@
 //
 // A mesh is a series of primitives (vertices, normals, texture coordinates) and
 // a texture to apply to them.
+//
+// If the context supports OpenGL 1.5, meshes are drawn from vertex & index
+// buffer objects (captured in a vertex array object if it supports OpenGL
+// 3.0).  Otherwise a display list is used.
 
 #ifndef CARCASSONNE_GFX_MESH_H_
 #define CARCASSONNE_GFX_MESH_H_
@@ -31,6 +35,7 @@
 #include <vector>
 
 #include "carcassonne/gfx/texture.h"
+#include "carcassonne/gfx/graphics_configuration.h"
 
 namespace carcassonne {
 
@@ -41,12 +46,29 @@ namespace gfx {
 class Mesh
 {
 public:
+   // One vertex of the interleaved vertex buffer.
+   struct Vertex
+   {
+      glm::vec3 texture_coord;
+      glm::vec3 normal;
+      glm::vec3 position;
+   };
+
    Mesh(AssetManager& asset_mgr, const std::string& name);
    ~Mesh();
 
+   // (Re)creates the mesh's OpenGL objects in the current context, choosing
+   // buffer objects or a display list based on the context's OpenGL version.
    void init();
 
    const std::string& getName() const;
+   const Texture* getTexture() const;
+
+   // The mesh's distinct vertices, and its primitives broken into triangles
+   // (as indices into getVertices()), for copying into a Batch.  There are
+   // no triangles if the mesh is made of points or lines.
+   const std::vector<Vertex>& getVertices() const;
+   const std::vector<GLuint>& getTriangles() const;
 
    // Uses texture specified by this mesh
    // make sure depth buffer writing and GL_DEPTH_TEST are enabled before drawing!
@@ -59,9 +81,19 @@ public:
    void drawBase() const;
    
 private:
+   void buildBuffers();
+   void buildTriangles();
+   void destroy();
+   void bindBuffers() const;
+   void unbindBuffers() const;
+
    std::string name_;
+   const GraphicsConfiguration& gfx_cfg_;
 
-   mutable GLuint display_list_id_;
+   GLuint display_list_id_;
+   GLuint vertex_buffer_id_;
+   GLuint index_buffer_id_;
+   GLuint vertex_array_id_;
 
    GLenum primitive_type_;
 
@@ -70,6 +102,12 @@ private:
    std::vector<glm::vec3> normals_;
    std::vector<glm::vec3> texture_coords_;
 
+   // indices_ with each distinct (vertex, normal, texture coordinate)
+   // combination made into a single Vertex.
+   std::vector<Vertex> buffer_vertices_;
+   std::vector<GLuint> buffer_indices_;
+   std::vector<GLuint> triangles_;
+
    const Texture* texture_;
 
    Mesh(const Mesh&);
@@ -40,6 +40,7 @@
 #include "carcassonne/_carcassonne.h"
 
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <SFML/OpenGL.hpp>
 
@@ -52,10 +53,16 @@ class Texture
 {
 public:
    Texture(db::DB& db, const std::string& name);
+   Texture(db::DB& db, const std::string& name, const glm::ivec2& size, const GLubyte* data);
    ~Texture();
 
    void init();
 
+   // Replaces the texture with size.x * size.y RGBA pixels.
+   void init(const glm::ivec2& size, const GLubyte* data);
+
+   static void loadPixels(db::DB& db, const std::string& name, glm::ivec2& size, std::vector<GLubyte>& pixels);
+
    const std::string& getName() const;
    GLuint getTextureGlId() const;
 
@@ -72,13 +79,6 @@ private:
    static void checkUnknown();
    static void checkMode(GLenum mode);
    void checkTexture() const;
-   
-   enum State { UNKNOWN, DISABLED, ENABLED };
-
-   static State state_;
-   static GLuint bound_id_;
-   static GLenum mode_;
-   static glm::vec4 color_;
 
    db::DB& db_;
    std::string name_;
@@ -0,0 +1,87 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/texture_atlas.h
+//
+// Several textures packed into the cells of one larger texture, so things
+// using different textures can be drawn together (e.g. in one Batch).  The
+// fixed-function pipeline can't sample array textures, so each layer is just
+// a rectangle of the atlas.  The atlas is composed on the CPU, so it works
+// with any OpenGL version.
+
+#ifndef CARCASSONNE_GFX_TEXTURE_ATLAS_H_
+#define CARCASSONNE_GFX_TEXTURE_ATLAS_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <memory>
+
+#include "carcassonne/db/db.h"
+#include "carcassonne/gfx/graphics_configuration.h"
+#include "carcassonne/gfx/texture.h"
+
+namespace carcassonne {
+namespace gfx {
+
+class TextureAtlas
+{
+public:
+   // Packs the textures named in textures (layer i is textures[i]).  Throws
+   // std::runtime_error if one can't be loaded or the atlas would be too
+   // large for the context.
+   TextureAtlas(db::DB& db, const std::string& name, const std::vector<std::string>& textures,
+                const GraphicsConfiguration& gfx_cfg);
+
+   void init();
+
+   const std::string& getName() const;
+   const Texture& getTexture() const;
+
+   size_t getLayerCount() const;
+
+   // The rectangle of the atlas holding layer: (x, y) is its corner and
+   // (z, w) its size, in texture coordinates.
+   const glm::vec4& getLayerRect(size_t layer) const;
+
+private:
+   enum { GUTTER = 1 }; // pixels around each cell copied from the edge of
+                        // its texture, so linear filtering doesn't pick up
+                        // the neighbouring cells
+
+   void build(glm::ivec2& size, std::vector<GLubyte>& pixels);
+
+   db::DB& db_;
+   std::string name_;
+   std::vector<std::string> textures_;
+   const GraphicsConfiguration& gfx_cfg_;
+
+   std::vector<glm::vec4> rects_;
+   std::unique_ptr<Texture> texture_;
+
+   // Disable copy-construction & assignment - do not implement
+   TextureAtlas(const TextureAtlas&);
+   void operator=(const TextureAtlas&);
+};
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
+
+#endif
@@ -47,7 +47,7 @@ protected:
    MainMenu(const MainMenu& other);
 
    enum PlayerType {
-      HUMAN, MACHINE, NONE
+      HUMAN, MACHINE, MACHINE_HARD, NONE
    };
 
    PlayerType player_types[6];
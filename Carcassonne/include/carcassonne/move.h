@@ -0,0 +1,77 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/move.h
+//
+// A complete turn: where the current tile is placed, in which rotation, and
+// which of its features (if any) the current player's follower is placed on.
+// Moves are applied to and undone from a GameState (see GameState::apply()
+// and GameState::undo()), which lets AI players search ahead without copying
+// the game.
+
+#ifndef CARCASSONNE_MOVE_H_
+#define CARCASSONNE_MOVE_H_
+#include "carcassonne/_carcassonne.h"
+
+#include "carcassonne/tile.h"
+
+namespace carcassonne {
+
+struct Move
+{
+   Move()
+      : rotation(Tile::ROTATION_NONE),
+        follower(NO_FOLLOWER)
+   {
+   }
+
+   Move(const glm::ivec2& position, Tile::Rotation rotation, int follower = NO_FOLLOWER)
+      : position(position),
+        rotation(rotation),
+        follower(follower)
+   {
+   }
+
+   enum {
+      NO_FOLLOWER = -1
+   };
+
+   glm::ivec2 position;       // board coordinates
+   Tile::Rotation rotation;
+
+   // index of the feature (see Tile::getFeature()) of the placed tile where
+   // the current player's follower is placed, or NO_FOLLOWER.
+   int follower;
+
+   bool operator==(const Move& other) const
+   {
+      return position == other.position && rotation == other.rotation && follower == other.follower;
+   }
+
+   bool operator!=(const Move& other) const
+   {
+      return !(*this == other);
+   }
+};
+
+} // namespace carcassonne
+
+#endif
@@ -21,7 +21,10 @@
 // Author: Benjamin Crist
 // File: carcassonne/pile.h
 //
-// Represents a LIFO pile of tiles.  The pile can also be shuffled.
+// Represents a LIFO pile of tiles.  The pile can also be shuffled.  Tiles
+// in the pile are just references to a prototype in the pile's Tileset; the
+// Tile object is only created when it is removed from the pile.  All the
+// features of a pile's tiles share one FeaturePool.
 
 #ifndef CARCASSONNE_PILE_H_
 #define CARCASSONNE_PILE_H_
@@ -32,36 +35,111 @@
 #include <random>
 
 #include "carcassonne/tile.h"
+#include "carcassonne/tileset.h"
 
 namespace carcassonne {
 
-class AssetManager;
-
 class Pile
 {
 public:
-   Pile();
-   Pile(unsigned int seed);
+   // Creates an empty pile.
+   explicit Pile(unsigned int seed);
+
+   // The PRNG moves with the tiles, so a seeded pile stays seeded.
    Pile(Pile&& other);
    Pile& operator=(Pile&& other);
 
-   Pile(AssetManager& asset_mgr, const std::string& tileset_name);
+   // Creates a full pile of the tiles in tileset, with the starting tile on
+   // top, using seed for the tiles' starting rotations and for shuffling, so
+   // the same seed always deals the same game.
+   Pile(const std::shared_ptr<const Tileset>& tileset, unsigned int seed);
+
+   // Loads a new Tileset.  Prefer loading the tileset once and reusing it
+   // (see AssetManager::getTileSet()).
+   Pile(db::DB& db, const std::string& tileset_name, unsigned int seed);
+
+   // Creates a pile containing the same tiles as other (but not the same
+   // Tile objects), shuffled using seed.  AI players use this to guess at the
+   // order of the tiles remaining in the real draw pile.
+   Pile(const Pile& other, unsigned int seed);
 
-   void setSeed();
    void setSeed(unsigned int seed);
 
-   void add(std::unique_ptr<Tile>&& tile);
+   // Both piles must use the same tileset (or one of them must be empty)
    void add(Pile&& other);
 
+   // Puts a tile of prototype (which must be in this pile's tileset) on top.
+   void add(const TilePrototype& prototype, Tile::Rotation rotation);
+
    void shuffle();
 
    int size() const;
 
+   const std::shared_ptr<const Tileset>& getTileset() const;
+
+   // The XOR of the zobrist::pile() keys of each prototype remaining in the
+   // pile.  Only depends on which tiles are in the pile, not their order.
+   unsigned long long getHash() const;
+
+   // The number of tiles of each prototype (indexed by TilePrototype::index)
+   // remaining in the pile.
+   const std::vector<int>& getCounts() const;
+
+   // The number of tiles remaining in the pile which would fit (in at least
+   // one rotation) at an empty location with the given constraints (see
+   // Board::getConstraints()).  Kept up to date as tiles are removed and put
+   // back, so this is just a table lookup.
+   int getFittingCount(unsigned char constraints) const;
+
+   // Moves a tile of prototype to the top of the pile, so it is the next one
+   // removed.  Returns false if there are none in the pile.
+   bool moveToTop(size_t prototype);
+
    std::unique_ptr<Tile> remove();
 
+   // Puts a floating tile which was removed from this pile back on top, so
+   // that it is the next tile to be removed (see GameState::undo()).  The
+   // same Tile object is returned by remove(), so its features aren't
+   // allocated again.
+   void putBack(std::unique_ptr<Tile>&& tile);
+
 private:
+   struct Entry
+   {
+      int prototype;          // index in tileset_
+      Tile::Rotation rotation;
+      bool returned;          // true if the tile is the top of returned_
+   };
+
+   // forgets which entries returned tiles belong to; their entries are just
+   // references to a prototype again.  The Tile objects are kept in spares_
+   // rather than destroyed, because the features they allocated can't be
+   // released from features_pool_ individually.
+   void clearReturned();
+
+   // recalculates counts_, fitting_counts_, and hash_ from tiles_
+   void rehash();
+   void count(int prototype, int delta);
+
+   void fill();
+
    std::mt19937 prng_; // PRNG => psudo-random number generator
-   std::vector<std::unique_ptr<Tile> > tiles_;
+   std::shared_ptr<const Tileset> tileset_;
+   std::vector<Entry> tiles_;
+   std::vector<std::unique_ptr<Tile> > returned_; // see putBack()
+
+   // Floating tiles which aren't associated with an entry any more, indexed
+   // by prototype.  remove() reuses these before allocating a new Tile, so
+   // no more than one Tile is ever allocated for each tile in the pile, no
+   // matter how many times it is shuffled (see MonteCarloSearch).
+   std::vector<std::vector<std::unique_ptr<Tile> > > spares_;
+   std::vector<int> counts_;  // number of entries in tiles_ for each prototype
+   std::vector<int> fitting_counts_;   // see getFittingCount(); indexed by
+                                       // constraints
+   unsigned long long hash_;  // see getHash()
+
+   // Allocates the features of tiles removed from this pile.
+   std::shared_ptr<features::FeaturePool> features_pool_;
 
    // Disable copy-construction & assignment - do not implement
    Pile(const Pile&);
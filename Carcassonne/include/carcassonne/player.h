@@ -23,7 +23,9 @@
 //
 // Represents a human or AI player, including name and win/loss record, and
 // skill level (for AI players).  Additionally, the player class stores
-// some information specific to the current scenario (game).
+// some information specific to the current scenario (game).  The players
+// owned by Game are profiles; each game plays with its own copies (see
+// GameContext).
 
 #ifndef CARCASSONNE_PLAYER_H_
 #define CARCASSONNE_PLAYER_H_
@@ -37,8 +39,6 @@
 
 namespace carcassonne {
 
-class AssetManager;
-
 class Player
 {
 public:
@@ -58,9 +58,10 @@ public:
    const std::string& getName() const;
    void setHuman(bool human);
    bool isHuman() const;
+   void setSkillLevel(SkillLevel skill_level);
    SkillLevel getSkillLevel() const;
 
-   void recordScenarioResult(bool won);
+   void recordScenarioResult(bool won, int score);
 
    int getWins() const;
    int getLosses() const;
@@ -71,7 +72,7 @@ public:
 
    // Specific to current game:
 
-   void newScenario(AssetManager& asset_mgr, const glm::vec4& color);
+   void newScenario(const glm::vec4& color);
 
    void setColor(const glm::vec4& color);
    const glm::vec4& getColor() const;
@@ -80,17 +81,12 @@ public:
    Follower* getIdleFollower();
    size_t getIdleFollowerCount() const;
    void organizeIdleFollowers();
+   const std::vector<Follower>& getFollowers() const;
 
    // increase score_;
    void scorePoints(int points);
    int getScore() const;
 
-   // display this player's HUD if it's their turn
-   void draw() const;
-
-   // display this player's placed followers
-   void drawPlacedFollowers() const;
-
 private:
    std::string name_;
    bool human_;
@@ -0,0 +1,87 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/pool.h
+//
+// Stores objects of a single type in fixed-size blocks.  Objects are
+// addressed by their index, never move once constructed, and are all
+// destroyed together when the pool is cleared or destroyed.  There is no
+// way to release a single object, so owners which come and go (like Tiles,
+// which own features) must be reused rather than discarded, or the pool
+// grows without bound.
+
+#ifndef CARCASSONNE_POOL_H_
+#define CARCASSONNE_POOL_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+
+namespace carcassonne {
+
+template <typename T>
+class Pool
+{
+public:
+   enum {
+      BLOCK_SIZE_BITS = 8,
+      BLOCK_SIZE = 1 << BLOCK_SIZE_BITS,
+      BLOCK_MASK = BLOCK_SIZE - 1
+   };
+
+   Pool();
+   ~Pool();
+
+   // Returns uninitialized storage for the next object.  The object must be
+   // constructed there with placement new, then add() must be called before
+   // the pool is used again, eg:
+   //    new (pool.reserve()) T(args);
+   //    unsigned int index = pool.add();
+   void* reserve();
+   unsigned int add();
+
+   T& operator[](unsigned int index) const;
+
+   unsigned int size() const;
+
+   // destroys all objects in the pool (but keeps the storage for reuse)
+   void clear();
+
+private:
+   struct Block
+   {
+      typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type objects[BLOCK_SIZE];
+   };
+
+   std::vector<std::unique_ptr<Block> > blocks_;
+   unsigned int size_;
+
+   // Disable copy-construction & assignment - do not implement
+   Pool(const Pool&);
+   void operator=(const Pool&);
+};
+
+} // namespace carcassonne
+
+#include "carcassonne/pool.inl"
+
+#endif
@@ -0,0 +1,84 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/pool.inl
+
+#ifndef CARCASSONNE_POOL_INL_
+#define CARCASSONNE_POOL_INL_
+
+#ifndef CARCASSONNE_POOL_H_
+#include "carcassonne/pool.h"
+#endif
+
+namespace carcassonne {
+
+template <typename T>
+Pool<T>::Pool()
+   : size_(0)
+{
+}
+
+template <typename T>
+Pool<T>::~Pool()
+{
+   clear();
+}
+
+template <typename T>
+void* Pool<T>::reserve()
+{
+   unsigned int block = size_ >> BLOCK_SIZE_BITS;
+   if (block == blocks_.size())
+      blocks_.push_back(std::unique_ptr<Block>(new Block));
+
+   return &blocks_[block]->objects[size_ & BLOCK_MASK];
+}
+
+template <typename T>
+unsigned int Pool<T>::add()
+{
+   return size_++;
+}
+
+template <typename T>
+T& Pool<T>::operator[](unsigned int index) const
+{
+   return *reinterpret_cast<T*>(&blocks_[index >> BLOCK_SIZE_BITS]->objects[index & BLOCK_MASK]);
+}
+
+template <typename T>
+unsigned int Pool<T>::size() const
+{
+   return size_;
+}
+
+template <typename T>
+void Pool<T>::clear()
+{
+   for (unsigned int i = 0; i < size_; ++i)
+      (*this)[i].~T();
+
+   size_ = 0;
+}
+
+} // namespace carcassonne
+
+#endif
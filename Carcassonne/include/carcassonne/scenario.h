@@ -33,9 +33,11 @@
 #include <SFML/System.hpp>
 #include <SFML/Window.hpp>
 
-#include "carcassonne/board.h"
-#include "carcassonne/pile.h"
-#include "carcassonne/player.h"
+#include "carcassonne/game_context.h"
+#include "carcassonne/game_state.h"
+#include "carcassonne/ai/background_search.h"
+#include "carcassonne/ai/evaluator.h"
+#include "carcassonne/gfx/board_renderer.h"
 #include "carcassonne/gfx/perspective_camera.h"
 #include "carcassonne/gfx/ortho_camera.h"
 #include "carcassonne/gfx/texture_font.h"
@@ -49,7 +51,13 @@ class Game;
 
 struct ScenarioInit
 {
-   std::vector<Player*> players;
+   // tiles is replaced by the pile from AssetManager::getTileSet()
+   ScenarioInit()
+      : tiles(0)
+   {
+   }
+
+   std::unique_ptr<GameContext> context;
    Pile tiles;
    std::unique_ptr<Tile> starting_tile;
 };
@@ -64,7 +72,6 @@ public:
 
    void placeTile(const glm::ivec2& board_coords);
    void placeFollower(const glm::vec3& world_coords, bool limit_distance);
-   void endTurn();
 
    void zoom(float factor, bool lock_xz);
 
@@ -113,21 +120,24 @@ private:
    sf::Clock clock_;
    sf::Time min_simulate_interval_;
    bool paused_;
+   bool show_render_stats_;   // toggled with F3
    scheduling::Unifier simulation_unifier_;
    scheduling::PersistentSequence simulation_sequence_;
 
-   bool game_over_;
-   
-   Board board_;
-   Pile draw_pile_;
-   std::vector<Player*> players_;
-
-   std::vector<Player*>::iterator current_player_; // iterator to the player
-                                                   // whose turn it is
-   std::unique_ptr<Tile> current_tile_; // the tile that is currently being played
-   Tile* last_placed_tile_;
-   Follower* current_follower_;
-   std::vector<std::shared_ptr<features::Feature> > follower_placeholders_;
+   std::unique_ptr<GameContext> context_;
+   GameState state_;
+   gfx::BoardRenderer renderer_;
+
+   // SKILL_LEVEL_HARD players think on another thread
+   ai::BackgroundSearch machine_search_;
+   bool machine_thinking_;
+
+   // SKILL_LEVEL_EASY & SKILL_LEVEL_NORMAL players play the move the
+   // evaluator likes best
+   ai::Evaluator machine_evaluator_;
+
+   void onTurnChanged();
+   bool finishMachineTurn();
 
    // Disable copy-construction & assignment - do not implement
    Scenario(const Scenario&);
@@ -29,18 +29,19 @@
 #include "carcassonne/_carcassonne.h"
 
 #include <vector>
-#include <random>
+#include <string>
+#include <memory>
 
-#include "carcassonne/gfx/mesh.h"
 #include "carcassonne/features/feature.h"
 #include "carcassonne/features/city.h"
 #include "carcassonne/features/cloister.h"
 #include "carcassonne/features/farm.h"
 #include "carcassonne/features/road.h"
+#include "carcassonne/features/feature_pool.h"
 
 namespace carcassonne {
 
-class AssetManager;
+struct TilePrototype;
 
 // Structure that represents the features present on a particular side of a tile
 struct TileEdge
@@ -80,6 +81,9 @@ public:
       // a tile which is in a pile or currently being placed.
       TYPE_FLOATING = 1,
 
+      // The TYPE_EMPTY_* types describe empty locations on the board (see
+      // Board::getEmptyType()).  Tile objects never have these types.
+
       // a placeholder for a spot on the board where the tile that is currently
       // being placed could be placed.  Should have a semitransparent green
       // color.
@@ -112,14 +116,12 @@ public:
       SIDE_WEST = 3
    };
    
-   // Constructs a tile of one of the TYPE_EMPTY_* types
-   Tile(AssetManager& asset_mgr, Type type);
-   
-   // Load tile from database
-   Tile(AssetManager& asset_mgr, const std::string& name);
-
-   // Copy another tile (does not share feature objects)
-   Tile(const Tile& other);
+   // Create a floating tile from a prototype (see Tileset).  The tile's
+   // features are allocated from pool; everything else is shared with the
+   // prototype.  The features aren't released when the tile is destroyed,
+   // only when the pool is.
+   Tile(const std::shared_ptr<const TilePrototype>& prototype, Rotation rotation,
+        const std::shared_ptr<features::FeaturePool>& pool);
 
 
    // Sets the tile's type.  A TYPE_EMPTY_* tile can only be set to any of the
@@ -134,6 +136,12 @@ public:
 
    Rotation getRotation() const;
 
+   const TilePrototype& getPrototype() const;
+
+   // The name of the texture used to render this tile.  Resolved by the
+   // renderer, not the tile.
+   const std::string& getTextureName() const;
+
    void setPosition(const glm::vec3& position);
    const glm::vec3& getPosition() const;
 
@@ -143,8 +151,28 @@ public:
    // Returns the type of features which currently exist on the requested side.
    const TileEdge& getEdge(Side side) const;
 
+   // Returns the features which would be on the requested side if the tile
+   // were in the given rotation.
+   const TileEdge& getEdge(Side side, Rotation rotation) const;
+
+   // Returns the TileEdge::Type of all 4 sides packed into 8 bits, 2 bits per
+   // side, with SIDE_NORTH in the lowest bits.  The signatures for all 4
+   // rotations are calculated when the tile's prototype is loaded, so this
+   // is just a table lookup.
+   unsigned char getEdgeSignature() const;   // current rotation
+   unsigned char getEdgeSignature(Rotation rotation) const;
+
+   // Features are ordered cities, roads, farms, then the cloister (if any).
    size_t getFeatureCount() const;
-   std::weak_ptr<features::Feature> getFeature(size_t index);
+   features::Feature* getFeature(size_t index) const;
+   features::FeatureHandle getFeatureHandle(size_t index) const;
+
+   // Returns the index of one of this tile's features (see getFeature()).
+   size_t getFeatureIndex(const features::Feature& feature) const;
+
+   // called when the tile is placed on the board, before closing any sides.
+   // Each of the tile's features becomes a new region in regions.
+   void addToRegions(features::RegionStore& regions);
 
    // called when a tile is placed next to existing tiles
    void closeSide(Side side, Tile* new_neighbor);
@@ -152,49 +180,30 @@ public:
    // called when a tile is placed kitty-corner to existing tiles
    void closeDiagonal(Tile* new_diagonal_neighbor);
 
-   void checkForCompleteFeatures();
-
-   void draw() const;
-   void drawPlaceholders() const;
+   // reverse closeSide() and closeDiagonal() when a placement is undone (see
+   // Board::undoPlacement()).  Region changes are undone separately by the
+   // RegionStore.
+   void openSide(Side side, Tile* neighbor);
+   void openDiagonal(Tile* diagonal_neighbor);
 
-   void setPlaceholderColor(const glm::vec4& color);
+   // Changes a TYPE_PLACED tile back into a TYPE_FLOATING tile.  Called
+   // after all of its sides have been opened.
+   void lift();
 
-   void replaceCity(const features::City& old_city, features::City& new_city);
-   void replaceFarm(const features::Farm& old_farm, features::Farm& new_farm);
-   void replaceRoad(const features::Road& old_road, features::Road& new_road);
+   void checkForCompleteFeatures();
    
 
 private:
-   struct FeatureRef
-   {
-      int id;
-      TileEdge::Type type;
-      union {
-         features::Farm* farm;
-         features::Road* road;
-         features::City* city;
-      };
-
-      bool operator==(const FeatureRef& other) const
-      {
-         return id == other.id;
-      }
-   };
-
-   FeatureRef getFeature(AssetManager& asset_mgr, db::Stmt& sf, std::vector<FeatureRef>& features, int id);
    TileEdge& getEdge_(Side side);
+   features::Cloister* getCloister_() const;
    void checkForCompleteCloister();
    void calculateTransform() const;
    void calculateInverseTransform() const;
 
-   static std::mt19937 prng_;
+   std::shared_ptr<const TilePrototype> prototype_;
 
    Type type_;
 
-   glm::vec4 color_;
-   gfx::Mesh* mesh_;
-   gfx::Texture* texture_;
-
    glm::vec3 position_;
    Rotation rotation_;
    mutable glm::mat4 transform_;
@@ -203,12 +212,16 @@ private:
 
    TileEdge edges_[4];
 
-   std::vector<std::shared_ptr<features::Feature> > cities_;
-   std::vector<std::shared_ptr<features::Feature> > roads_;
-   std::vector<std::shared_ptr<features::Feature> > farms_;
-   std::shared_ptr<features::Feature> cloister_;
+   // The pool which owns this tile's features.  Shared by all the tiles
+   // drawn from the same pile.
+   std::shared_ptr<features::FeaturePool> features_pool_;
+
+   std::vector<features::FeatureHandle> features_; // see getFeature()
+   unsigned char farms_begin_;   // index of the first farm in features_
+   unsigned char farms_end_;     // index of the cloister, if there is one
 
-   // Disable assignment - do not implement
+   // Disable copy-construction & assignment - do not implement
+   Tile(const Tile&);
    void operator=(const Tile&);
 };
 
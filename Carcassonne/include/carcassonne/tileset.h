@@ -0,0 +1,120 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/tileset.h
+//
+// Immutable descriptions of the tiles in a tileset.  Each distinct tile is
+// loaded from the database once into a TilePrototype, which describes its
+// edges, features, and follower placeholders.  Tile objects refer to their
+// prototype instead of querying the database, and a Pile is just a list of
+// prototype indices.
+
+#ifndef CARCASSONNE_TILESET_H_
+#define CARCASSONNE_TILESET_H_
+#include "carcassonne/_carcassonne.h"
+
+#include <vector>
+#include <string>
+
+#include "carcassonne/tile.h"
+#include "carcassonne/follower.h"
+
+namespace carcassonne {
+namespace db {
+
+class DB;
+class Stmt;
+
+} // namespace carcassonne::db
+
+struct TilePrototype
+{
+   // A city, road, or farm on the tile.
+   struct Feature
+   {
+      TileEdge::Type type;
+      int pennants;                     // cities only
+      Follower placeholder;
+      std::vector<int> adjacent_cities; // farms only; indices into features
+   };
+
+   // Refers to the features on one side of the (unrotated) tile.
+   struct Edge
+   {
+      TileEdge::Type type;
+      int feature;   // index into features
+      int cw_farm;   // -1 if type is not TYPE_ROAD
+      int ccw_farm;
+   };
+
+   std::string name;
+   std::string texture_name;
+   size_t index;  // see Tileset::getPrototype()
+
+   // cities, roads, and farms in the order they are loaded.
+   std::vector<Feature> features;
+   Edge edges[4];
+
+   bool cloister;
+   Follower cloister_placeholder;
+
+   // see Tile::getEdgeSignature()
+   unsigned char edge_signatures[4];  // indexed by Tile::Rotation
+
+   // The constraints (see Board::getConstraints()) of every kind of empty
+   // location where the tile fits in at least one rotation.
+   std::vector<unsigned char> fitting_constraints;
+};
+
+class Tileset
+{
+public:
+   Tileset(db::DB& db, const std::string& name);
+
+   const std::string& getName() const;
+
+   size_t size() const;
+   const TilePrototype& getPrototype(size_t index) const;
+
+   // The number of copies of a prototype in a full pile, not counting the
+   // starting tile.
+   int getQuantity(size_t index) const;
+
+   size_t getStartingTile() const;
+
+private:
+   size_t loadPrototype(db::Stmt& s, db::Stmt& sf, const std::string& tile_name);
+   Follower loadPlaceholder(db::Stmt& sf);
+   int loadFeature(db::Stmt& sf, TilePrototype& prototype, std::vector<int>& ids, int id);
+
+   std::string name_;
+   std::vector<TilePrototype> prototypes_;
+   std::vector<int> quantities_;
+   size_t starting_tile_;
+
+   // Disable copy-construction & assignment - do not implement
+   Tileset(const Tileset&);
+   void operator=(const Tileset&);
+};
+
+} // namespace carcassonne
+
+#endif
@@ -0,0 +1,65 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/zobrist.h
+//
+// Zobrist keys for hashing game states.  A state's hash is the XOR of the
+// keys of everything in it, so it can be updated incrementally as tiles are
+// placed and removed, and the same position reached by different move
+// orders has the same hash.
+//
+// The board has no fixed size, so instead of a table of random numbers each
+// key is generated by mixing its inputs with the MurmurHash3/SplitMix64
+// finalizer.  Keys are the same on every run and in every thread.
+
+#ifndef CARCASSONNE_ZOBRIST_H_
+#define CARCASSONNE_ZOBRIST_H_
+#include "carcassonne/_carcassonne.h"
+
+namespace carcassonne {
+namespace zobrist {
+
+// a tile with the prototype at index prototype (see TilePrototype::index)
+// placed at position in the given rotation.
+unsigned long long tile(const glm::ivec2& position, size_t prototype, int rotation);
+
+// a follower belonging to the player in seat placed at position (in world
+// coordinates, see Follower::getPosition()).
+unsigned long long follower(size_t seat, const glm::vec3& position);
+
+unsigned long long score(size_t seat, int score);
+
+// count copies of prototype remaining in the draw pile.  0 if count is 0, so
+// an empty pile hashes to 0.
+unsigned long long pile(size_t prototype, int count);
+
+// the tile that the current player is placing
+unsigned long long currentTile(size_t prototype);
+
+// the player in seat is the current player
+unsigned long long turn(size_t seat);
+
+} // namespace carcassonne::zobrist
+} // namespace carcassonne
+
+#include "carcassonne/zobrist.inl"
+
+#endif
@@ -0,0 +1,111 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/zobrist.inl
+
+#ifndef CARCASSONNE_ZOBRIST_INL_
+#define CARCASSONNE_ZOBRIST_INL_
+
+#ifndef CARCASSONNE_ZOBRIST_H_
+#include "carcassonne/zobrist.h"
+#endif
+
+#include <cstring>
+
+namespace carcassonne {
+namespace zobrist {
+namespace detail {
+
+enum KeyType {
+   KEY_TILE = 1,
+   KEY_FOLLOWER = 2,
+   KEY_SCORE = 3,
+   KEY_PILE = 4,
+   KEY_CURRENT_TILE = 5,
+   KEY_TURN = 6
+};
+
+inline unsigned long long mix(unsigned long long h)
+{
+   h += 0x9e3779b97f4a7c15ULL;
+   h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+   return h ^ (h >> 31);
+}
+
+inline unsigned long long key(KeyType type, unsigned long long a, unsigned long long b)
+{
+   return mix(mix(mix(static_cast<unsigned long long>(type)) ^ a) ^ b);
+}
+
+inline unsigned long long pack(unsigned int x, unsigned int y)
+{
+   return (static_cast<unsigned long long>(x) << 32) | y;
+}
+
+inline unsigned int bits(float f)
+{
+   unsigned int i;
+   memcpy(&i, &f, sizeof(i));
+   return i;
+}
+
+} // namespace carcassonne::zobrist::detail
+
+inline unsigned long long tile(const glm::ivec2& position, size_t prototype, int rotation)
+{
+   return detail::key(detail::KEY_TILE, detail::pack(position.x, position.y), (prototype << 2) | rotation);
+}
+
+inline unsigned long long follower(size_t seat, const glm::vec3& position)
+{
+   return detail::key(detail::KEY_FOLLOWER,
+                      detail::pack(detail::bits(position.x), detail::bits(position.z)),
+                      (static_cast<unsigned long long>(seat) << 32) | detail::bits(position.y));
+}
+
+inline unsigned long long score(size_t seat, int score)
+{
+   return detail::key(detail::KEY_SCORE, seat, static_cast<unsigned int>(score));
+}
+
+inline unsigned long long pile(size_t prototype, int count)
+{
+   if (count == 0)
+      return 0;
+
+   return detail::key(detail::KEY_PILE, prototype, static_cast<unsigned int>(count));
+}
+
+inline unsigned long long currentTile(size_t prototype)
+{
+   return detail::key(detail::KEY_CURRENT_TILE, prototype, 0);
+}
+
+inline unsigned long long turn(size_t seat)
+{
+   return detail::key(detail::KEY_TURN, seat, 0);
+}
+
+} // namespace carcassonne::zobrist
+} // namespace carcassonne
+
+#endif
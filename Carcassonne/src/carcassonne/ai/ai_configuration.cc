@@ -0,0 +1,143 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/ai_configuration.cc
+//
+// AiConfiguration is a DAO for accessing the settings of machine players
+// stored in a Carcassonne configuration database.
+
+#include "carcassonne/ai/ai_configuration.h"
+
+#include "carcassonne/db/stmt.h"
+
+namespace carcassonne {
+namespace ai {
+
+///////////////////////////////////////////////////////////////////////////////
+// Loads and returns the active AiConfiguration from the database provided.
+// If the database contains no configuration data, or if an error occurs, the
+// default configuration is returned.  The evaluator weights are loaded
+// separately (see Evaluator::Weights::load()).
+AiConfiguration AiConfiguration::load(db::DB& db)
+{
+   AiConfiguration cfg;
+   cfg.weights = Evaluator::Weights::load(db);
+
+   try
+   {
+      if (db.getInt("SELECT count(*) "
+                    "FROM sqlite_master "
+                    "WHERE type='table' "
+                    "AND name='cc_ai_cfg'", 0) > 0)
+      {
+         // Load config data from the database
+         db::Stmt s(db, "SELECT "
+                        "turn_time, threads, endgame_tiles " // 0, 1, 2
+                        "FROM cc_ai_cfg ORDER BY ROWID DESC LIMIT 1");
+         if (s.step())
+         {
+            cfg.turn_time = s.getInt(0);
+            cfg.threads = s.getInt(1);
+            cfg.endgame_tiles = s.getInt(2);
+
+            return cfg;
+         }
+      }
+   }
+   catch (const db::DB::error& err)
+   {
+      std::cerr << "Error loading AI configuration: " << err.what();
+   }
+
+   AiConfiguration defaults;
+   defaults.weights = cfg.weights;
+   return defaults;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructs an AiConfiguration using default values
+AiConfiguration::AiConfiguration()
+   : turn_time(2000),
+     threads(0),
+     endgame_tiles(1)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Saves the content of this AiConfiguration to the database provided and
+// makes it the active AiConfiguration in the database.  Old AI configuration
+// data is retained in the database in the form of a stack; the record with
+// the highest ROWID is the active one.
+//
+// Returns true if the AiConfiguration was saved successfully or false if an
+// error occurred.
+bool AiConfiguration::save(db::DB& db)
+{
+   try
+   {
+      // Create the AI config table if it doesn't exist
+      db.exec("CREATE TABLE IF NOT EXISTS cc_ai_cfg ("
+              "ROWID INTEGER PRIMARY KEY AUTOINCREMENT, "
+              "turn_time INTEGER, "
+              "threads INTEGER, "
+              "endgame_tiles INTEGER)");
+
+      // Save config data to database
+      db::Stmt s(db, "INSERT INTO cc_ai_cfg ("
+                     "turn_time, threads, endgame_tiles" // 1, 2, 3
+                     ") VALUES (?,?,?)");
+      s.bind(1, static_cast<int>(turn_time));
+      s.bind(2, static_cast<int>(threads));
+      s.bind(3, endgame_tiles);
+
+      s.step();
+
+      return weights.save(db);
+   }
+   catch (const db::DB::error& err)
+   {
+      std::cerr << "Error saving AI configuration: " << err.what();
+   }
+
+   return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The Monte Carlo search stops when the turn's time runs out.
+MonteCarloSearch::Options AiConfiguration::getSearchOptions() const
+{
+   MonteCarloSearch::Options options;
+   options.threads = threads;
+   options.time_limit = sf::milliseconds(turn_time);
+   return options;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The endgame solver is used for the last few turns instead.
+EndgameSolver::Options AiConfiguration::getSolverOptions() const
+{
+   EndgameSolver::Options options;
+   options.max_tiles = endgame_tiles;
+   return options;
+}
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
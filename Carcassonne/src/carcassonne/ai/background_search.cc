@@ -0,0 +1,138 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/background_search.cc
+//
+// Runs a machine player's search on a worker thread.
+
+#include "carcassonne/ai/background_search.h"
+
+#include <sstream>
+
+namespace carcassonne {
+namespace ai {
+
+#pragma warning (push)
+#pragma warning (disable: 4355)
+BackgroundSearch::BackgroundSearch(const MonteCarloSearch::Options& search_options, const EndgameSolver::Options& solver_options)
+   : search_(search_options),
+     solver_(solver_options),
+     thread_(&BackgroundSearch::run, this),
+     running_(false),
+     cancelled_(false),
+     has_move_(false)
+{
+}
+#pragma warning (pop)
+
+BackgroundSearch::~BackgroundSearch()
+{
+   cancel();
+   thread_.wait();
+}
+
+// The snapshot is taken on the calling thread, so the caller's GameState is
+// only read while it can't be changing.
+void BackgroundSearch::start(const GameState& state, unsigned int seed)
+{
+   cancel();
+   thread_.wait();
+
+   const std::vector<Player*>& players = state.getPlayers();
+   players_.clear();
+   seats_.clear();
+   for (auto i(players.begin()), end(players.end()); i != end; ++i)
+   {
+      players_.push_back(std::unique_ptr<Player>(new Player((*i)->getName(), false)));
+      seats_.push_back(players_.back().get());
+   }
+
+   state_.reset(new GameState(state, seats_, seed));
+   search_.setSeed(seed);
+
+   {
+      sf::Lock lock(mutex_);
+      running_ = true;
+      has_move_ = false;
+      report_.clear();
+   }
+   cancelled_ = false;
+
+   thread_.launch();
+}
+
+void BackgroundSearch::cancel()
+{
+   cancelled_ = true;
+}
+
+bool BackgroundSearch::isRunning() const
+{
+   sf::Lock lock(mutex_);
+   return running_;
+}
+
+bool BackgroundSearch::hasMove() const
+{
+   sf::Lock lock(mutex_);
+   return has_move_;
+}
+
+const Move& BackgroundSearch::getMove() const
+{
+   return move_;
+}
+
+const std::string& BackgroundSearch::getReport() const
+{
+   return report_;
+}
+
+void BackgroundSearch::run()
+{
+   std::ostringstream report;
+   Move move;
+
+   float margin;
+   if (solver_.isApplicable(*state_) && solver_.solve(*state_, move, margin, &cancelled_))
+   {
+      report << "solved endgame in " << solver_.getStats().nodes
+             << " nodes (expected margin " << margin << ")";
+   }
+   else if (!cancelled_)
+   {
+      move = search_.search(*state_, &cancelled_);
+
+      const MonteCarloSearch::Stats& stats = search_.getStats();
+      report << stats.playouts << " playouts in " << stats.elapsed.asSeconds()
+             << "s on " << stats.threads << " threads ("
+             << stats.getPlayoutsPerSecond() << " playouts/s)";
+   }
+
+   sf::Lock lock(mutex_);
+   running_ = false;
+   has_move_ = !cancelled_;
+   move_ = move;
+   report_ = report.str();
+}
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
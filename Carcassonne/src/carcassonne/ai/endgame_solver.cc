@@ -0,0 +1,352 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/endgame_solver.cc
+//
+// Exhaustive search of the last few turns of a game.
+
+#include "carcassonne/ai/endgame_solver.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace carcassonne {
+namespace ai {
+
+EndgameSolver::Options::Options()
+   : max_tiles(1),
+     margin_limit(40),
+     max_nodes(2000),
+     table_size(1 << 16)
+{
+}
+
+EndgameSolver::Stats::Stats()
+   : nodes(0),
+     table_hits(0),
+     complete(true)
+{
+}
+
+EndgameSolver::EndgameSolver(const Options& options)
+   : options_(options),
+     table_(options.table_size),
+     root_player_(nullptr),
+     cancelled_(nullptr)
+{
+}
+
+bool EndgameSolver::isApplicable(const GameState& state) const
+{
+   return state.getCurrentTile() && state.getDrawPile().size() <= options_.max_tiles;
+}
+
+bool EndgameSolver::solve(const GameState& state, Move& move, float& value, const volatile bool* cancelled)
+{
+   stats_ = Stats();
+   cancelled_ = cancelled;
+
+   if (!state.getCurrentTile())
+      return false;
+
+   const std::vector<Player*>& players = state.getPlayers();
+   players_.clear();
+   seats_.clear();
+   for (auto i(players.begin()), end(players.end()); i != end; ++i)
+   {
+      players_.push_back(std::unique_ptr<Player>(new Player((*i)->getName(), false)));
+      seats_.push_back(players_.back().get());
+   }
+
+   // every draw is searched, so the order of the copy's pile doesn't matter
+   state_.reset(new GameState(state, seats_, 0));
+   root_player_ = &state_->getCurrentPlayer();
+
+   // each turn is a decision node, plus one for the end of the game
+   size_t depth = state.getDrawPile().size() + 2;
+   moves_.resize(depth);
+   order_.resize(depth);
+   counts_.resize(depth);
+   for (auto i(moves_.begin()), end(moves_.end()); i != end; ++i)
+   {
+      if (i->empty())
+         i->resize(256);
+   }
+
+   table_.clear();
+
+   Move best;
+   float margin_limit = options_.margin_limit;
+   float result = search(0, -margin_limit - 1, margin_limit + 1, &best);
+
+   state_.reset();
+
+   if (!stats_.complete)
+      return false;
+
+   move = best;
+   value = result;
+   return true;
+}
+
+const EndgameSolver::Stats& EndgameSolver::getStats() const
+{
+   return stats_;
+}
+
+// Fail-soft alpha-beta: if the result is <= alpha it is an upper bound, if
+// it is >= beta it is a lower bound, otherwise it is exact.
+float EndgameSolver::search(size_t depth, float alpha, float beta, Move* best_move)
+{
+   if (options_.max_nodes > 0 && stats_.nodes >= options_.max_nodes)
+      stats_.complete = false;
+
+   if (cancelled_ && *cancelled_)
+      stats_.complete = false;
+
+   if (!stats_.complete)
+      return 0;
+
+   ++stats_.nodes;
+
+   if (state_->isGameOver())
+      return evaluate();
+
+   unsigned long long hash = state_->getHash();
+   unsigned long long data;
+   int first = -1;
+   if (table_.probe(hash, data))
+   {
+      ++stats_.table_hits;
+
+      float value;
+      Bound bound;
+      unpack(data, value, bound, first);
+
+      // the root needs to know the move, not just the value
+      if (!best_move)
+      {
+         if (bound == BOUND_EXACT ||
+             (bound == BOUND_LOWER && value >= beta) ||
+             (bound == BOUND_UPPER && value <= alpha))
+            return value;
+      }
+   }
+
+   std::vector<Move>& moves = moves_[depth];
+   size_t move_count = state_->getMoves(&moves[0], moves.size());
+   if (move_count > moves.size())
+   {
+      moves.resize(move_count);
+      state_->getMoves(&moves[0], moves.size());
+   }
+
+   if (move_count == 0)
+      return evaluate();
+
+   bool maximizing = &state_->getCurrentPlayer() == root_player_;
+   orderMoves(depth, move_count, maximizing, first);
+
+   float original_alpha = alpha;
+   float original_beta = beta;
+   float best_value = 0;
+   int best = -1;
+
+   const std::vector<std::pair<float, size_t> >& order = order_[depth];
+   for (auto i(order.begin()), end(order.end()); i != end; ++i)
+   {
+      float value = expect(depth, moves[i->second], alpha, beta);
+      if (!stats_.complete)
+         return 0;
+
+      if (maximizing)
+      {
+         if (best < 0 || value > best_value)
+         {
+            best_value = value;
+            best = i->second;
+         }
+         alpha = std::max(alpha, value);
+      }
+      else
+      {
+         if (best < 0 || value < best_value)
+         {
+            best_value = value;
+            best = i->second;
+         }
+         beta = std::min(beta, value);
+      }
+
+      if (alpha >= beta)
+         break;
+   }
+
+   Bound bound = BOUND_EXACT;
+   if (best_value <= original_alpha)
+      bound = BOUND_UPPER;
+   else if (best_value >= original_beta)
+      bound = BOUND_LOWER;
+   table_.store(hash, pack(best_value, bound, best));
+
+   if (best_move)
+      *best_move = moves[best];
+
+   return best_value;
+}
+
+// Star1: every value is between -margin_limit and margin_limit, so after
+// some of the tiles have been searched, the expectation is known to be
+// within a range.  If that range is outside the window, the rest of the
+// tiles don't matter.  Each tile is searched with the window that would
+// make that happen.
+float EndgameSolver::expect(size_t depth, const Move& move, float alpha, float beta)
+{
+   const Pile& pile = state_->getDrawPile();
+   int total = pile.size();
+
+   if (total == 0)
+   {
+      state_->apply(move);
+      float value = search(depth + 1, alpha, beta, nullptr);
+      state_->undo();
+      return value;
+   }
+
+   float low = -options_.margin_limit;
+   float high = options_.margin_limit;
+
+   // the pile's counts change while searching
+   std::vector<int>& counts = counts_[depth];
+   counts = pile.getCounts();
+
+   float sum = 0;
+   float searched = 0;
+   for (size_t tile = 0; tile < counts.size(); ++tile)
+   {
+      if (counts[tile] == 0)
+         continue;
+
+      float probability = counts[tile] / static_cast<float>(total);
+      float rest = std::max(0.0f, 1 - searched - probability);
+
+      float tile_alpha = std::max(low, (alpha - sum - rest * high) / probability);
+      float tile_beta = std::min(high, (beta - sum - rest * low) / probability);
+
+      state_->setNextTile(tile);
+      state_->apply(move);
+      float value = search(depth + 1, tile_alpha, tile_beta, nullptr);
+      state_->undo();
+
+      if (!stats_.complete)
+         return 0;
+
+      sum += probability * value;
+      searched += probability;
+      rest = std::max(0.0f, 1 - searched);
+
+      // a bound from the tile's search means this expectation is outside
+      // the window too (clamped, in case of rounding)
+      if (value <= tile_alpha && tile_alpha > low)
+         return std::min(alpha, sum + rest * high);
+      if (value >= tile_beta && tile_beta < high)
+         return std::max(beta, sum + rest * low);
+
+      if (sum + rest * high <= alpha)
+         return sum + rest * high;
+      if (sum + rest * low >= beta)
+         return sum + rest * low;
+   }
+
+   return sum;
+}
+
+float EndgameSolver::evaluate() const
+{
+   int best_opponent = 0;
+   bool first = true;
+   for (auto i(seats_.begin()), end(seats_.end()); i != end; ++i)
+   {
+      if (*i == root_player_)
+         continue;
+
+      if (first || (*i)->getScore() > best_opponent)
+         best_opponent = (*i)->getScore();
+      first = false;
+   }
+
+   float margin = static_cast<float>(root_player_->getScore() - best_opponent);
+   return std::max(-options_.margin_limit, std::min(options_.margin_limit, margin));
+}
+
+// The best move from the transposition table goes first.  On the last turn
+// each move only needs to be applied once anyway, so there is no point in
+// sorting.
+void EndgameSolver::orderMoves(size_t depth, size_t move_count, bool maximizing, int first)
+{
+   std::vector<std::pair<float, size_t> >& order = order_[depth];
+   order.clear();
+
+   bool last_turn = state_->getDrawPile().size() == 0;
+   std::vector<Move>& moves = moves_[depth];
+
+   for (size_t i = 0; i < move_count; ++i)
+   {
+      float key = 0;
+      if (static_cast<int>(i) == first)
+         key = 2 * options_.margin_limit + 1;
+      else if (!last_turn)
+      {
+         state_->apply(moves[i]);
+         key = evaluate();
+         state_->undo();
+
+         if (!maximizing)
+            key = -key;
+      }
+
+      order.push_back(std::make_pair(key, i));
+   }
+
+   if (!last_turn || first >= 0)
+      std::sort(order.begin(), order.end(), std::greater<std::pair<float, size_t> >());
+}
+
+unsigned long long EndgameSolver::pack(float value, Bound bound, int best)
+{
+   unsigned int bits;
+   std::memcpy(&bits, &value, sizeof(bits));
+
+   return bits | (static_cast<unsigned long long>(bound) << 32) | (static_cast<unsigned long long>(best + 1) << 34);
+}
+
+void EndgameSolver::unpack(unsigned long long data, float& value, Bound& bound, int& best)
+{
+   unsigned int bits = static_cast<unsigned int>(data);
+   std::memcpy(&value, &bits, sizeof(value));
+
+   bound = static_cast<Bound>((data >> 32) & 3);
+   best = static_cast<int>(data >> 34) - 1;
+}
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
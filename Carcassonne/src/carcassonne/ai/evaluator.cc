@@ -0,0 +1,577 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/evaluator.cc
+//
+// A heuristic estimate of what each player's position is worth, for use at
+// the leaves of a search.
+
+#include "carcassonne/ai/evaluator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "carcassonne/db/stmt.h"
+#include "carcassonne/features/city.h"
+#include "carcassonne/features/road.h"
+
+namespace carcassonne {
+namespace ai {
+namespace {
+
+// The names the weights are stored under in the cc_ai_weights table.
+struct WeightName
+{
+   const char* name;
+   float Evaluator::Weights::* weight;
+};
+
+const WeightName weight_names[] = {
+   { "fit_bias",            &Evaluator::Weights::fit_bias },
+   { "city_completion",     &Evaluator::Weights::city_completion },
+   { "road_extension",      &Evaluator::Weights::road_extension },
+   { "cloister_completion", &Evaluator::Weights::cloister_completion },
+   { "farm_city",           &Evaluator::Weights::farm_city },
+   { "contested_share",     &Evaluator::Weights::contested_share },
+   { "idle_follower",       &Evaluator::Weights::idle_follower }
+};
+
+const size_t weight_count = sizeof(weight_names) / sizeof(weight_names[0]);
+
+const glm::ivec2 sides[] = { glm::ivec2(1, 0), glm::ivec2(0, 1), glm::ivec2(-1, 0), glm::ivec2(0, -1) };
+
+} // namespace carcassonne::ai::(anon)
+
+Evaluator::Weights Evaluator::Weights::load(db::DB& db)
+{
+   Weights weights;
+
+   try
+   {
+      if (db.getInt("SELECT count(*) "
+                    "FROM sqlite_master "
+                    "WHERE type='table' "
+                    "AND name='cc_ai_weights'", 0) > 0)
+      {
+         db::Stmt s(db, "SELECT name, value FROM cc_ai_weights");
+         while (s.step())
+         {
+            const char* name = s.getText(0);
+            for (size_t i = 0; name && i < weight_count; ++i)
+            {
+               if (std::strcmp(name, weight_names[i].name) == 0)
+                  weights.*weight_names[i].weight = static_cast<float>(s.getDouble(1));
+            }
+         }
+      }
+   }
+   catch (const db::DB::error& err)
+   {
+      std::cerr << "Error loading AI weights: " << err.what();
+      return Weights();
+   }
+
+   return weights;
+}
+
+Evaluator::Weights::Weights()
+   : fit_bias(3.0f),
+     city_completion(1.0f),
+     road_extension(0.5f),
+     cloister_completion(0.8f),
+     farm_city(1.0f),
+     contested_share(0.25f),
+     idle_follower(1.5f)
+{
+}
+
+bool Evaluator::Weights::save(db::DB& db) const
+{
+   try
+   {
+      db.exec("CREATE TABLE IF NOT EXISTS cc_ai_weights ("
+              "name TEXT PRIMARY KEY, "
+              "value NUMERIC)");
+
+      db::Stmt s(db, "INSERT OR REPLACE INTO cc_ai_weights (name, value) VALUES (?,?)");
+      for (size_t i = 0; i < weight_count; ++i)
+      {
+         s.bind(1, weight_names[i].name);
+         s.bind(2, static_cast<double>(this->*weight_names[i].weight));
+         s.step();
+         s.reset();
+      }
+
+      return true;
+   }
+   catch (const db::DB::error& err)
+   {
+      std::cerr << "Error saving AI weights: " << err.what();
+   }
+
+   return false;
+}
+
+size_t Evaluator::Weights::size()
+{
+   return weight_count;
+}
+
+const char* Evaluator::Weights::getName(size_t index)
+{
+   return weight_names[index].name;
+}
+
+float& Evaluator::Weights::operator[](size_t index)
+{
+   return this->*weight_names[index].weight;
+}
+
+float Evaluator::Weights::operator[](size_t index) const
+{
+   return this->*weight_names[index].weight;
+}
+
+Evaluator::Region::Region()
+   : type(features::Feature::TYPE_FARM),
+     points(0),
+     open_locations(0),
+     adjacent_cities(0)
+{
+}
+
+Evaluator::Evaluator(const Weights& weights)
+   : weights_(weights)
+{
+   std::fill(follower_nodes_, follower_nodes_ + MAX_PLAYERS * MAX_FOLLOWERS, -1);
+}
+
+const Evaluator::Weights& Evaluator::getWeights() const
+{
+   return weights_;
+}
+
+void Evaluator::setWeights(const Weights& weights)
+{
+   weights_ = weights;
+}
+
+void Evaluator::reset(GameState& state)
+{
+   assert(state.getPlayers().size() <= MAX_PLAYERS);
+
+   features::RegionStore& regions = state.getBoard().getRegions();
+
+   journal_.clear();
+   regions_.assign(regions.size(), Region());
+   std::fill(follower_nodes_, follower_nodes_ + MAX_PLAYERS * MAX_FOLLOWERS, -1);
+
+   for (size_t node = 0; node < regions.size(); ++node)
+   {
+      int root = static_cast<int>(node);
+      if (regions.getRoot(root) != root)
+         continue;
+
+      regions_[root] = describe(state, root);
+      findFollowers(state, root);
+   }
+}
+
+// A placed tile can only change the regions on tiles in the 5x5 square
+// around it: those it joins, those with an open edge into a location next to
+// it (whose constraints change), and cloisters with an empty neighbor next
+// to it.
+void Evaluator::update(GameState& state, const Move& move)
+{
+   Board& board = state.getBoard();
+   features::RegionStore& regions = board.getRegions();
+
+   if (regions_.size() < regions.size())
+      regions_.resize(regions.size());
+
+   roots_.clear();
+   for (int x = -2; x <= 2; ++x)
+   {
+      for (int y = -2; y <= 2; ++y)
+      {
+         Tile* tile = board.getTileAt(move.position + glm::ivec2(x, y));
+         if (!tile)
+            continue;
+
+         for (size_t i = 0; i < tile->getFeatureCount(); ++i)
+         {
+            int root = regions.find(tile->getFeature(i)->getRegion());
+            if (std::find(roots_.begin(), roots_.end(), root) == roots_.end())
+               roots_.push_back(root);
+         }
+      }
+   }
+
+   JournalEntry entry;
+   entry.follower = -1;
+   entry.follower_node = -1;
+   for (auto i(roots_.begin()), end(roots_.end()); i != end; ++i)
+   {
+      entry.node = *i;
+      entry.region = regions_[*i];
+      journal_.push_back(entry);
+      regions_[*i] = describe(state, *i);
+   }
+
+   // The region the follower was placed in was unoccupied, so it is the
+   // only follower there (unless the region was completed and scored).
+   if (move.follower != Move::NO_FOLLOWER)
+   {
+      Tile* tile = board.getTileAt(move.position);
+      int node = tile->getFeature(move.follower)->getRegion();
+      const std::vector<Follower*>& followers = regions.getFollowers(node);
+      if (followers.size() == 1)
+      {
+         entry.node = -1;
+         entry.follower = getFollowerSlot(state, *followers[0]);
+         entry.follower_node = follower_nodes_[entry.follower];
+         journal_.push_back(entry);
+         follower_nodes_[entry.follower] = node;
+      }
+   }
+}
+
+size_t Evaluator::getUndoMark() const
+{
+   return journal_.size();
+}
+
+void Evaluator::undo(size_t mark)
+{
+   while (journal_.size() > mark)
+   {
+      const JournalEntry& entry = journal_.back();
+      if (entry.node >= 0)
+         regions_[entry.node] = entry.region;
+      else
+         follower_nodes_[entry.follower] = entry.follower_node;
+
+      journal_.pop_back();
+   }
+}
+
+void Evaluator::evaluate(const GameState& state, float* values) const
+{
+   const std::vector<Player*>& players = state.getPlayers();
+   size_t seats = players.size();
+
+   for (size_t seat = 0; seat < seats; ++seat)
+      values[seat] = static_cast<float>(players[seat]->getScore());
+
+   if (state.isGameOver())
+      return;
+
+   const features::RegionStore& regions = state.getBoard().getRegions();
+   const Pile& pile = state.getDrawPile();
+
+   // count the followers in each occupied region
+   int roots[MAX_PLAYERS * MAX_FOLLOWERS];
+   int counts[MAX_PLAYERS * MAX_FOLLOWERS][MAX_PLAYERS];
+   size_t occupied = 0;
+
+   for (size_t seat = 0; seat < seats; ++seat)
+   {
+      const std::vector<Follower>& followers = players[seat]->getFollowers();
+      int idle = 0;
+      for (size_t i = 0; i < followers.size(); ++i)
+      {
+         if (!followers[i].isPlaced())
+         {
+            if (followers[i].isIdle())
+               ++idle;
+            continue;
+         }
+
+         int root = regions.getRoot(follower_nodes_[seat * MAX_FOLLOWERS + i]);
+         size_t r = 0;
+         while (r < occupied && roots[r] != root)
+            ++r;
+
+         if (r == occupied)
+         {
+            roots[occupied++] = root;
+            std::fill(counts[r], counts[r] + seats, 0);
+         }
+
+         ++counts[r][seat];
+      }
+
+      values[seat] += idle * weights_.idle_follower;
+   }
+
+   // share out each region's value
+   for (size_t r = 0; r < occupied; ++r)
+   {
+      int most = 0;
+      for (size_t seat = 0; seat < seats; ++seat)
+         most = std::max(most, counts[r][seat]);
+
+      float value = getValue(regions, pile, regions_[roots[r]]);
+
+      for (size_t seat = 0; seat < seats; ++seat)
+      {
+         if (counts[r][seat] == most)
+            values[seat] += value;
+         else if (counts[r][seat] > 0)
+            values[seat] += weights_.contested_share * value;
+      }
+   }
+}
+
+float Evaluator::evaluate(const GameState& state, size_t seat) const
+{
+   float values[MAX_PLAYERS];
+   evaluate(state, values);
+
+   bool first = true;
+   float best_other = 0;
+   for (size_t other = 0; other < state.getPlayers().size(); ++other)
+   {
+      if (other != seat && (first || values[other] > best_other))
+      {
+         best_other = values[other];
+         first = false;
+      }
+   }
+
+   return values[seat] - best_other;
+}
+
+// After each move is applied, the draw pile is missing the tile drawn for
+// the next player, which the current player wouldn't know yet, but that's
+// only one tile.
+Move Evaluator::getBestMove(GameState& state)
+{
+   const std::vector<Player*>& players = state.getPlayers();
+   size_t seat = std::find(players.begin(), players.end(), &state.getCurrentPlayer()) - players.begin();
+
+   size_t count = state.getMoves(moves_.data(), moves_.size());
+   if (count > moves_.size())
+   {
+      moves_.resize(count);
+      count = state.getMoves(moves_.data(), moves_.size());
+   }
+
+   reset(state);
+   size_t mark = getUndoMark();
+
+   size_t best = 0;
+   float best_margin = 0;
+   for (size_t i = 0; i < count; ++i)
+   {
+      state.apply(moves_[i]);
+      update(state, moves_[i]);
+
+      float margin = evaluate(state, seat);
+      if (i == 0 || margin > best_margin)
+      {
+         best = i;
+         best_margin = margin;
+      }
+
+      state.undo();
+      undo(mark);
+   }
+
+   return count > 0 ? moves_[best] : Move();
+}
+
+// Cities and roads: the distinct empty locations their open edges face.
+// Cloisters: the empty locations around them (which may not be next to any
+// placed tile yet, in which case their constraints are 0).
+Evaluator::Region Evaluator::describe(GameState& state, int root)
+{
+   Board& board = state.getBoard();
+   features::RegionStore& regions = board.getRegions();
+   const features::Feature& feature = regions.getFeature(root);
+
+   Region region;
+   region.type = feature.getType();
+
+   locations_.clear();
+
+   switch (region.type)
+   {
+      case features::Feature::TYPE_CITY:
+      case features::Feature::TYPE_ROAD:
+      {
+         bool city = region.type == features::Feature::TYPE_CITY;
+         region.points = regions.getTileCount(root) + (city ? regions.getPennants(root) : 0);
+
+         int node = root;
+         do
+         {
+            const features::Feature& f = regions.getFeature(node);
+            const Tile& tile = f.getTile();
+            glm::ivec2 position(board.getCoordinates(tile.getPosition()));
+
+            for (int side = 0; side < 4; ++side)
+            {
+               const TileEdge& edge = tile.getEdge(static_cast<Tile::Side>(side));
+               if (!edge.open)
+                  continue;
+
+               if (city ? (edge.type == TileEdge::TYPE_CITY && edge.city == &f)
+                        : (edge.type == TileEdge::TYPE_ROAD && edge.road == &f))
+               {
+                  glm::ivec2 location(position + sides[side]);
+                  if (std::find(locations_.begin(), locations_.end(), location) == locations_.end())
+                     locations_.push_back(location);
+               }
+            }
+
+            node = regions.getNext(node);
+         } while (node != root);
+         break;
+      }
+
+      case features::Feature::TYPE_CLOISTER:
+      {
+         glm::ivec2 position(board.getCoordinates(feature.getTile().getPosition()));
+
+         region.points = 1;
+         for (int x = -1; x <= 1; ++x)
+         {
+            for (int y = -1; y <= 1; ++y)
+            {
+               if (x == 0 && y == 0)
+                  continue;
+
+               glm::ivec2 location(position + glm::ivec2(x, y));
+               if (board.getTileAt(location))
+                  ++region.points;
+               else
+                  locations_.push_back(location);
+            }
+         }
+         break;
+      }
+
+      case features::Feature::TYPE_FARM:
+      {
+         regions.getAdjacentCities(root, scratch_);
+         region.adjacent_cities = std::min(static_cast<int>(scratch_.size()), static_cast<int>(MAX_ADJACENT_CITIES));
+         std::copy(scratch_.begin(), scratch_.begin() + region.adjacent_cities, region.cities);
+         break;
+      }
+   }
+
+   region.open_locations = locations_.size();
+   for (int i = 0; i < region.open_locations && i < MAX_OPEN_LOCATIONS; ++i)
+      region.constraints[i] = board.getConstraints(locations_[i]);
+
+   return region;
+}
+
+void Evaluator::findFollowers(GameState& state, int root)
+{
+   const std::vector<Follower*>& followers = state.getBoard().getRegions().getFollowers(root);
+   for (auto i(followers.begin()), end(followers.end()); i != end; ++i)
+      follower_nodes_[getFollowerSlot(state, **i)] = root;
+}
+
+int Evaluator::getFollowerSlot(const GameState& state, const Follower& follower) const
+{
+   const std::vector<Player*>& players = state.getPlayers();
+   const Player* owner = follower.getOwner();
+
+   size_t seat = std::find(players.begin(), players.end(), owner) - players.begin();
+   size_t index = &follower - &owner->getFollowers()[0];
+
+   assert(seat < players.size() && index < MAX_FOLLOWERS);
+   return static_cast<int>(seat * MAX_FOLLOWERS + index);
+}
+
+// The chance of filling each location is estimated independently.
+float Evaluator::getFillChance(const Pile& pile, unsigned char constraints) const
+{
+   if (constraints == 0)
+      return 1;
+
+   float fitting = static_cast<float>(pile.getFittingCount(constraints));
+   return fitting / (fitting + weights_.fit_bias);
+}
+
+float Evaluator::getCompletionChance(const Pile& pile, const Region& region) const
+{
+   if (region.open_locations > MAX_OPEN_LOCATIONS)
+      return 0;
+
+   float chance = 1;
+   for (int i = 0; i < region.open_locations; ++i)
+      chance *= getFillChance(pile, region.constraints[i]);
+
+   return chance;
+}
+
+float Evaluator::getValue(const features::RegionStore& regions, const Pile& pile, const Region& region) const
+{
+   switch (region.type)
+   {
+      case features::Feature::TYPE_CITY:
+         // a complete city is worth double
+         return region.points * (1 + weights_.city_completion * getCompletionChance(pile, region));
+
+      case features::Feature::TYPE_ROAD:
+      {
+         float extension = 0;
+         for (int i = 0; i < region.open_locations && i < MAX_OPEN_LOCATIONS; ++i)
+            extension += getFillChance(pile, region.constraints[i]);
+
+         return region.points + weights_.road_extension * extension;
+      }
+
+      case features::Feature::TYPE_CLOISTER:
+      {
+         float filled = 0;
+         for (int i = 0; i < region.open_locations; ++i)
+            filled += getFillChance(pile, region.constraints[i]);
+
+         return region.points + weights_.cloister_completion * filled;
+      }
+
+      case features::Feature::TYPE_FARM:
+      {
+         int cities[MAX_ADJACENT_CITIES];
+         float value = 0;
+         for (int i = 0; i < region.adjacent_cities; ++i)
+         {
+            // cities may have been joined since the farm was described
+            cities[i] = regions.getRoot(region.cities[i]);
+            if (std::find(cities, cities + i, cities[i]) == cities + i)
+               value += getCompletionChance(pile, regions_[cities[i]]);
+         }
+
+         return 3 * weights_.farm_city * value;
+      }
+   }
+
+   return 0;
+}
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
@@ -0,0 +1,499 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/monte_carlo_search.cc
+//
+// Monte Carlo tree search for the machine player's next move.
+
+#include "carcassonne/ai/monte_carlo_search.h"
+
+#include <ctime>
+#include <memory>
+#include <random>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace carcassonne {
+namespace ai {
+
+// Searches one copy of the game.  Each thread has its own Worker.
+class MonteCarloSearch::Worker
+{
+public:
+   Worker(const GameState& state, const Options& options, unsigned int seed, unsigned int playouts,
+          const sf::Clock& clock, const volatile bool* cancelled);
+
+   // Runs playouts until the budget runs out.
+   void run();
+
+   unsigned int getPlayouts() const;
+   size_t getNodeCount() const;
+
+   // Adds the number of times each move at the root was visited to visits.
+   void addRootVisits(std::vector<std::pair<Move, unsigned int> >& visits) const;
+
+private:
+   enum {
+      NO_NODE = -1,
+      NO_TILE = -1   // a decision node where the game is over
+   };
+
+   // Decision nodes are reached by drawing a tile (or by ending the game);
+   // their children are chance nodes.  Chance nodes are reached by playing a
+   // move; their children are decision nodes, one for each tile which has
+   // been drawn next.
+   struct Node
+   {
+      Move move;           // chance nodes: the move played
+      int tile;            // decision nodes: the prototype index of the tile drawn
+      int seat;            // chance nodes: the player who played move
+      int first_child;
+      int next_sibling;
+      int children;
+      int move_count;      // decision nodes: the number of legal moves, or
+                           // -1 if they haven't been generated yet
+      unsigned int visits;
+      float reward;        // chance nodes: the sum of seat's rewards
+   };
+
+   void playout();
+
+   int addChild(int parent);
+   int selectChild(int node) const;
+   int findDecision(int chance, int tile) const;
+
+   int getCurrentTile() const;
+   int getCurrentSeat() const;
+   size_t generateMoves();
+
+   // Sets rewards_ to each player's share of the win.
+   void score();
+
+   const sf::Clock& clock_;
+   const volatile bool* cancelled_;
+   sf::Time time_limit_;
+   unsigned int max_playouts_;
+   unsigned int playouts_;
+   float exploration_;
+
+   std::mt19937 prng_;
+
+   std::vector<std::unique_ptr<Player> > players_;
+   std::vector<Player*> seats_;
+   std::unique_ptr<GameState> state_;
+
+   std::vector<Node> nodes_;
+   std::vector<Move> moves_;
+   std::vector<int> path_;
+   std::vector<float> rewards_;
+
+   // Disable copy-construction & assignment - do not implement
+   Worker(const Worker&);
+   void operator=(const Worker&);
+};
+
+MonteCarloSearch::Worker::Worker(const GameState& state, const Options& options, unsigned int seed, unsigned int playouts,
+                                 const sf::Clock& clock, const volatile bool* cancelled)
+   : clock_(clock),
+     cancelled_(cancelled),
+     time_limit_(options.time_limit),
+     max_playouts_(playouts),
+     playouts_(0),
+     exploration_(options.exploration),
+     prng_(static_cast<std::mt19937::result_type>(seed)),
+     moves_(256)
+{
+   const std::vector<Player*>& players = state.getPlayers();
+   for (auto i(players.begin()), end(players.end()); i != end; ++i)
+   {
+      players_.push_back(std::unique_ptr<Player>(new Player((*i)->getName(), false)));
+      seats_.push_back(players_.back().get());
+   }
+
+   state_.reset(new GameState(state, seats_, seed));
+   rewards_.resize(seats_.size());
+
+   Node root;
+   root.tile = getCurrentTile();
+   root.seat = -1;
+   root.first_child = NO_NODE;
+   root.next_sibling = NO_NODE;
+   root.children = 0;
+   root.move_count = -1;
+   root.visits = 0;
+   root.reward = 0;
+   nodes_.push_back(root);
+}
+
+void MonteCarloSearch::Worker::run()
+{
+   if (state_->isGameOver())
+      return;
+
+   while (max_playouts_ == 0 || playouts_ < max_playouts_)
+   {
+      if (time_limit_ != sf::Time::Zero && clock_.getElapsedTime() >= time_limit_)
+         break;
+
+      if (cancelled_ && *cancelled_)
+         break;
+
+      playout();
+   }
+}
+
+unsigned int MonteCarloSearch::Worker::getPlayouts() const
+{
+   return playouts_;
+}
+
+size_t MonteCarloSearch::Worker::getNodeCount() const
+{
+   return nodes_.size();
+}
+
+void MonteCarloSearch::Worker::addRootVisits(std::vector<std::pair<Move, unsigned int> >& visits) const
+{
+   for (int child = nodes_[0].first_child; child != NO_NODE; child = nodes_[child].next_sibling)
+   {
+      const Node& node = nodes_[child];
+
+      auto i(visits.begin()), end(visits.end());
+      while (i != end && i->first != node.move)
+         ++i;
+
+      if (i == end)
+         visits.push_back(std::make_pair(node.move, node.visits));
+      else
+         i->second += node.visits;
+   }
+}
+
+// Selection & expansion add at most one chance node and one decision node
+// to the tree, then the game is finished with random moves.  Every move is
+// undone afterwards, so the game is back at the root for the next playout.
+void MonteCarloSearch::Worker::playout()
+{
+   state_->shuffleDrawPile();
+
+   size_t applied = 0;
+   int node = 0;
+   path_.clear();
+   path_.push_back(node);
+
+   while (!state_->isGameOver())
+   {
+      if (nodes_[node].move_count < 0)
+         nodes_[node].move_count = generateMoves();
+
+      int chance;
+      if (nodes_[node].children < nodes_[node].move_count)
+      {
+         // generate the moves again, since moves_ may have been used for a
+         // different node since this one's moves were counted.
+         generateMoves();
+         Move move = moves_[nodes_[node].children];
+
+         chance = addChild(node);
+         nodes_[chance].move = move;
+         nodes_[chance].seat = getCurrentSeat();
+      }
+      else
+         chance = selectChild(node);
+
+      path_.push_back(chance);
+      if (!state_->apply(nodes_[chance].move))
+         break;
+      ++applied;
+
+      int tile = getCurrentTile();
+      node = findDecision(chance, tile);
+      if (node == NO_NODE)
+      {
+         node = addChild(chance);
+         nodes_[node].tile = tile;
+         path_.push_back(node);
+         break;
+      }
+
+      path_.push_back(node);
+   }
+
+   while (!state_->isGameOver())
+   {
+      size_t move_count = generateMoves();
+      if (move_count == 0 || !state_->apply(moves_[prng_() % move_count]))
+         break;
+
+      ++applied;
+   }
+
+   score();
+
+   for (auto i(path_.begin()), end(path_.end()); i != end; ++i)
+   {
+      Node& node = nodes_[*i];
+      ++node.visits;
+      if (node.seat >= 0)
+         node.reward += rewards_[node.seat];
+   }
+
+   while (applied > 0)
+   {
+      state_->undo();
+      --applied;
+   }
+
+   ++playouts_;
+}
+
+int MonteCarloSearch::Worker::addChild(int parent)
+{
+   Node child;
+   child.tile = NO_TILE;
+   child.seat = -1;
+   child.first_child = NO_NODE;
+   child.children = 0;
+   child.move_count = -1;
+   child.visits = 0;
+   child.reward = 0;
+
+   int index = nodes_.size();
+
+   Node& p = nodes_[parent];
+   child.next_sibling = p.first_child;
+   p.first_child = index;
+   ++p.children;
+
+   nodes_.push_back(child);
+   return index;
+}
+
+// UCB1
+int MonteCarloSearch::Worker::selectChild(int node) const
+{
+   float log_visits = std::log(static_cast<float>(nodes_[node].visits));
+
+   int best = NO_NODE;
+   float best_value = 0;
+   for (int child = nodes_[node].first_child; child != NO_NODE; child = nodes_[child].next_sibling)
+   {
+      const Node& c = nodes_[child];
+      float value = c.reward / c.visits + exploration_ * std::sqrt(log_visits / c.visits);
+
+      if (best == NO_NODE || value > best_value)
+      {
+         best = child;
+         best_value = value;
+      }
+   }
+
+   return best;
+}
+
+int MonteCarloSearch::Worker::findDecision(int chance, int tile) const
+{
+   for (int child = nodes_[chance].first_child; child != NO_NODE; child = nodes_[child].next_sibling)
+   {
+      if (nodes_[child].tile == tile)
+         return child;
+   }
+
+   return NO_NODE;
+}
+
+int MonteCarloSearch::Worker::getCurrentTile() const
+{
+   Tile* tile = state_->getCurrentTile();
+   return tile ? static_cast<int>(tile->getPrototype().index) : NO_TILE;
+}
+
+int MonteCarloSearch::Worker::getCurrentSeat() const
+{
+   const Player* player = &state_->getCurrentPlayer();
+   for (size_t seat = 0; seat < seats_.size(); ++seat)
+   {
+      if (seats_[seat] == player)
+         return seat;
+   }
+
+   return -1;
+}
+
+size_t MonteCarloSearch::Worker::generateMoves()
+{
+   size_t move_count = state_->getMoves(&moves_[0], moves_.size());
+   if (move_count > moves_.size())
+   {
+      moves_.resize(move_count);
+      state_->getMoves(&moves_[0], moves_.size());
+   }
+
+   return move_count;
+}
+
+void MonteCarloSearch::Worker::score()
+{
+   int high_score = 0;
+   int winners = 0;
+   for (auto i(seats_.begin()), end(seats_.end()); i != end; ++i)
+   {
+      int score = (*i)->getScore();
+      if (winners == 0 || score > high_score)
+      {
+         high_score = score;
+         winners = 1;
+      }
+      else if (score == high_score)
+         ++winners;
+   }
+
+   for (size_t seat = 0; seat < seats_.size(); ++seat)
+      rewards_[seat] = seats_[seat]->getScore() == high_score ? 1.0f / winners : 0.0f;
+}
+
+MonteCarloSearch::Options::Options()
+   : threads(0),
+     playouts(0),
+     time_limit(sf::seconds(1)),
+     exploration(0.7f),
+     seed(static_cast<unsigned int>(time(nullptr)))
+{
+}
+
+MonteCarloSearch::Stats::Stats()
+   : threads(0),
+     playouts(0),
+     nodes(0)
+{
+}
+
+float MonteCarloSearch::Stats::getPlayoutsPerSecond() const
+{
+   float seconds = elapsed.asSeconds();
+   return seconds > 0 ? playouts / seconds : 0;
+}
+
+MonteCarloSearch::MonteCarloSearch(const Options& options)
+   : options_(options)
+{
+   if (options_.playouts == 0 && options_.time_limit == sf::Time::Zero)
+      throw std::runtime_error("Monte Carlo search needs a playout or time limit!");
+
+   if (options_.threads == 0)
+      options_.threads = getHardwareThreads();
+}
+
+// Each thread gets an equal share of the playout budget and a different
+// seed, so the copies of the draw pile are shuffled differently.
+Move MonteCarloSearch::search(const GameState& state, const volatile bool* cancelled)
+{
+   sf::Clock clock;
+   unsigned int threads = options_.threads;
+
+   std::vector<std::unique_ptr<Worker> > workers;
+   for (unsigned int i = 0; i < threads; ++i)
+   {
+      unsigned int playouts = options_.playouts / threads;
+      if (i < options_.playouts % threads)
+         ++playouts;
+
+      if (options_.playouts > 0 && playouts == 0)
+         break;
+
+      workers.push_back(std::unique_ptr<Worker>(new Worker(state, options_, options_.seed + i, playouts, clock, cancelled)));
+   }
+
+   if (workers.size() == 1)
+      workers[0]->run();
+   else
+   {
+      std::vector<std::unique_ptr<sf::Thread> > worker_threads;
+      for (auto i(workers.begin()), end(workers.end()); i != end; ++i)
+      {
+         worker_threads.push_back(std::unique_ptr<sf::Thread>(new sf::Thread(&Worker::run, i->get())));
+         worker_threads.back()->launch();
+      }
+
+      for (auto i(worker_threads.begin()), end(worker_threads.end()); i != end; ++i)
+         (*i)->wait();
+   }
+
+   stats_.threads = workers.size();
+   stats_.playouts = 0;
+   stats_.nodes = 0;
+   stats_.elapsed = clock.getElapsedTime();
+
+   std::vector<std::pair<Move, unsigned int> > visits;
+   for (auto i(workers.begin()), end(workers.end()); i != end; ++i)
+   {
+      stats_.playouts += (*i)->getPlayouts();
+      stats_.nodes += (*i)->getNodeCount();
+      (*i)->addRootVisits(visits);
+   }
+
+   // the most visited move is the most reliable
+   Move best;
+   unsigned int best_visits = 0;
+   for (auto i(visits.begin()), end(visits.end()); i != end; ++i)
+   {
+      if (i->second > best_visits)
+      {
+         best = i->first;
+         best_visits = i->second;
+      }
+   }
+
+   options_.seed += threads;
+   return best;
+}
+
+void MonteCarloSearch::setSeed(unsigned int seed)
+{
+   options_.seed = seed;
+}
+
+const MonteCarloSearch::Stats& MonteCarloSearch::getStats() const
+{
+   return stats_;
+}
+
+unsigned int MonteCarloSearch::getHardwareThreads()
+{
+#ifdef _WIN32
+   SYSTEM_INFO info;
+   GetSystemInfo(&info);
+   unsigned int threads = info.dwNumberOfProcessors;
+#else
+   long threads = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+   return threads > 0 ? static_cast<unsigned int>(threads) : 1;
+}
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
@@ -0,0 +1,78 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/ai/transposition_table.cc
+//
+// A fixed-size table of search results keyed by GameState::getHash().
+
+#include "carcassonne/ai/transposition_table.h"
+
+namespace carcassonne {
+namespace ai {
+
+TranspositionTable::TranspositionTable(size_t size)
+{
+   size_t capacity = 1;
+   while (capacity <= size / 2)
+      capacity *= 2;
+
+   entries_.reset(new Entry[capacity]);
+   mask_ = capacity - 1;
+   clear();
+}
+
+size_t TranspositionTable::size() const
+{
+   return mask_ + 1;
+}
+
+// check == data == 0 would validate as an entry for hash 0, so empty
+// entries get a check value which doesn't match their slot.
+void TranspositionTable::clear()
+{
+   for (size_t i = 0; i <= mask_; ++i)
+   {
+      entries_[i].data = 0;
+      entries_[i].check = ~static_cast<unsigned long long>(i);
+   }
+}
+
+bool TranspositionTable::probe(unsigned long long hash, unsigned long long& data) const
+{
+   const Entry& entry = entries_[static_cast<size_t>(hash) & mask_];
+
+   if ((entry.check ^ entry.data) != hash)
+      return false;
+
+   data = entry.data;
+   return true;
+}
+
+void TranspositionTable::store(unsigned long long hash, unsigned long long data)
+{
+   Entry& entry = entries_[static_cast<size_t>(hash) & mask_];
+
+   entry.check = hash ^ data;
+   entry.data = data;
+}
+
+} // namespace carcassonne::ai
+} // namespace carcassonne
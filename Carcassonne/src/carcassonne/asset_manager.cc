@@ -23,6 +23,8 @@
 
 #include "carcassonne/asset_manager.h"
 
+#include "carcassonne/game.h"
+
 namespace carcassonne {
 
 AssetManager::AssetManager(Game& game, const std::string& filename)
@@ -36,6 +38,11 @@ db::DB& AssetManager::getDB()
    return db_;
 }
 
+const gfx::GraphicsConfiguration& AssetManager::getGraphicsConfiguration() const
+{
+   return game_.getGraphicsConfiguration();
+}
+
 void AssetManager::reload()
 {
    for (auto i(textures_.begin()), end(textures_.end()); i != end; ++i)
@@ -64,6 +71,21 @@ void AssetManager::reload()
          std::cerr << "Failed to reinitialize mesh \"" << i->second->getName() << "\": " << err.what() << std::endl;
       }
    }
+
+   for (auto i(tile_atlases_.begin()), end(tile_atlases_.end()); i != end; ++i)
+   {
+      if (!i->second)
+         continue;
+
+      try
+      {
+         i->second->init();
+      }
+      catch (const std::runtime_error& err)
+      {
+         std::cerr << "Failed to reinitialize texture atlas \"" << i->second->getName() << "\": " << err.what() << std::endl;
+      }
+   }
 }
 
 gfx::Texture* AssetManager::getTexture(const std::string& name)
@@ -164,19 +186,54 @@ std::unique_ptr<gui::Menu> AssetManager::getMenu(const std::string& name)
 
 
 // Returns a pile of all the tiles in a specific tileset.  The top tile is the
-// tileset's starting tile.
-Pile AssetManager::getTileSet(const std::string& name)
+// tileset's starting tile.  The tileset is only loaded from the database the
+// first time it is requested.  The pile's PRNG (for tile rotations and
+// shuffling) is seeded with seed.
+Pile AssetManager::getTileSet(const std::string& name, unsigned int seed)
 {
    try
    {
-      return Pile(*this, name);
+      std::shared_ptr<const Tileset>& ptr = tilesets_[name];
+
+      if (!ptr)
+      {
+         ptr = std::make_shared<Tileset>(db_, name);
+         getTileAtlas(*ptr);
+      }
+
+      return Pile(ptr, seed);
    }
    catch (std::runtime_error& err)
    {
       std::cerr << "Failed to load tileset \"" << name << "\": " << err.what() << std::endl;
    }
 
-   return Pile();
+   return Pile(seed);
+}
+
+// If the atlas can't be built, that is remembered so it isn't retried.
+const gfx::TextureAtlas* AssetManager::getTileAtlas(const Tileset& tileset)
+{
+   auto i(tile_atlases_.find(tileset.getName()));
+   if (i != tile_atlases_.end())
+      return i->second.get();
+
+   std::unique_ptr<gfx::TextureAtlas>& ptr = tile_atlases_[tileset.getName()];
+
+   try
+   {
+      std::vector<std::string> textures(tileset.size());
+      for (size_t p = 0; p < tileset.size(); ++p)
+         textures[p] = tileset.getPrototype(p).texture_name;
+
+      ptr.reset(new gfx::TextureAtlas(db_, "tileset:" + tileset.getName(), textures, getGraphicsConfiguration()));
+   }
+   catch (const std::runtime_error& err)
+   {
+      std::cerr << "Failed to build texture atlas for tileset \"" << tileset.getName() << "\": " << err.what() << std::endl;
+   }
+
+   return ptr.get();
 }
 
 } // namespace carcassonne
@@ -21,19 +21,50 @@
 // Author: Benjamin Crist / Josh Douglas
 // File: carcassonne/board.cc
 //
-// Represents a map of the game world - by using a std::unordered_map of tiles
+// Represents a map of the game world - tiles are stored in a dense grid of
+// fixed size chunks which are allocated as the board grows.
 
 #include "carcassonne/board.h"
 
-#include "carcassonne/asset_manager.h"
+#include "carcassonne/tileset.h"
+#include "carcassonne/zobrist.h"
 
 namespace carcassonne {
 
-Board::Board(AssetManager& asset_mgr)
-   : asset_mgr_(asset_mgr),
-     next_empty_location_(empty_locations_.begin())
+Board::Cell::Cell()
+   : empty_index(-1),
+     bucket_index(-1),
+     constraints(0)
 {
+}
+
+Board::Board()
+   : hash_(0),
+     next_empty_location_(0),
+     fitting_rotations_valid_(false),
+     fitting_rotations_signature_(0)
+{
+   for (int i = 0; i < 256; ++i)
+   {
+      Bucket& bucket = buckets_[i];
+      bucket.edge_mask = 0;
+      bucket.required_edges = 0;
+      bucket.fitting_rotations = 0;
+      bucket.type = Tile::TYPE_EMPTY_PLACEABLE;
+
+      for (int side = 0; side < 4; ++side)
+      {
+         int constraint = (i >> (2 * side)) & 0x3;
+         if (constraint != 0)
+         {
+            bucket.edge_mask |= 0x3 << (2 * side);
+            bucket.required_edges |= (constraint - 1) << (2 * side);
+         }
+      }
+   }
+
    makeEmpty(glm::ivec2(0,0));
+   addToBucket(glm::ivec2(0,0), *findCell(glm::ivec2(0,0)));
 }
 
 glm::ivec2 Board::getCoordinates(const glm::vec3& position) const
@@ -44,216 +75,576 @@ glm::ivec2 Board::getCoordinates(const glm::vec3& position) const
 
 Tile* Board::getTileAt(const glm::ivec2& position) const
 {
-   auto i(board_.find(position));
-   return i == board_.end() ? nullptr : i->second.get();
+   Cell* cell = findCell(position);
+   return cell ? cell->tile.get() : nullptr;
+}
+
+Tile::Type Board::getEmptyType(const glm::ivec2& position) const
+{
+   Cell* cell = findCell(position);
+   return cell && cell->empty_index >= 0 ? buckets_[cell->constraints].type : Tile::TYPE_EMPTY_NOT_PLACEABLE;
+}
+
+unsigned char Board::getConstraints(const glm::ivec2& position) const
+{
+   Cell* cell = findCell(position);
+   return cell && cell->empty_index >= 0 ? cell->constraints : 0;
 }
 
-// If tile is a TYPE_EMPTY_* tile, return false if the position already has
-// a tile of any kind.
-// If tile is a TYPE_FLOATING tile, return false if the position does not
-// currently have a TYPE_EMPTY_PLACEABLE tile.
-bool Board::placeTileAt(const glm::ivec2& position, std::unique_ptr<Tile>&& tile)
+// Returns false if tile is not a TYPE_FLOATING tile, or if the position
+// is not currently TYPE_EMPTY_PLACEABLE.
+bool Board::placeTileAt(const glm::ivec2& location, std::unique_ptr<Tile>&& tile)
 {
-   switch (tile->getType())
+   // location might refer to an element of empty_locations_ (e.g. from
+   // getNextPlaceableLocation()), which is modified below.
+   const glm::ivec2 position(location);
+
+   if (tile->getType() != Tile::TYPE_FLOATING)
+      return false;
+
+   Cell* cell = findCell(position);
+   if (cell == nullptr || cell->empty_index < 0 || buckets_[cell->constraints].type != Tile::TYPE_EMPTY_PLACEABLE)
+      return false;
+
+   removeFromBucket(*cell);
+
+   Placement placement;
+   placement.position = position;
+   placement.empty_index = cell->empty_index;
+   placement.regions_mark = regions_.getUndoMark();
+
+   // remove position from empty_locations_ by swapping the last location
+   // into its place.
+   size_t index = cell->empty_index;
+   const glm::ivec2& last = empty_locations_.back();
+   if (index != empty_locations_.size() - 1)
    {
-      case Tile::TYPE_EMPTY_NOT_PLACEABLE:
-      case Tile::TYPE_EMPTY_PLACEABLE_IF_ROTATED:
-      case Tile::TYPE_EMPTY_PLACEABLE:
-         if (getTileAt(position) != nullptr)
-            return false;
+      findCell(last)->empty_index = index;
+      empty_locations_[index] = last;
+   }
+   empty_locations_.pop_back();
+   cell->empty_index = -1;
+   next_empty_location_ = 0;
+   fitting_rotations_valid_ = false;
 
-         board_[position] = std::move(tile);
-         return true;
+   tile->setType(Tile::TYPE_PLACED);
+   tile->setPosition(glm::vec3(position.x, 0, position.y));
 
-      case Tile::TYPE_FLOATING:
-         {
-            Tile* old_tile = getTileAt(position);
-            if (old_tile == nullptr || old_tile->getType() != Tile::TYPE_EMPTY_PLACEABLE)
-               return false;
-
-            empty_locations_.erase(position);
-            next_empty_location_ = empty_locations_.begin();
-            tile->setType(Tile::TYPE_PLACED);
-            tile->setPosition(glm::vec3(position.x, 0, position.y));
-
-            Tile* north = makeEmpty(position + glm::ivec2(1, 0));
-            Tile* south = makeEmpty(position + glm::ivec2(-1, 0));
-            Tile* east = makeEmpty(position + glm::ivec2(0, 1));
-            Tile* west = makeEmpty(position + glm::ivec2(0, -1));
-            tile->closeSide(Tile::SIDE_NORTH, north);
-            tile->closeSide(Tile::SIDE_SOUTH, south);
-            tile->closeSide(Tile::SIDE_EAST, east);
-            tile->closeSide(Tile::SIDE_WEST, west);
-           
-            Tile* ne = getTileAt(position + glm::ivec2(1, 1));
-            Tile* nw = getTileAt(position + glm::ivec2(1, -1));
-            Tile* se = getTileAt(position + glm::ivec2(-1, 1));
-            Tile* sw = getTileAt(position + glm::ivec2(-1, -1));
-            tile->closeDiagonal(ne);
-            tile->closeDiagonal(nw);
-            tile->closeDiagonal(se);
-            tile->closeDiagonal(sw);
-
-            board_[position] = std::move(tile);
-            return true;
-         }
+   Tile* placed = tile.get();
+   cell->tile = std::move(tile);
+   placed_tiles_.push_back(placed);
+   placed->addToRegions(regions_);
+   hash_ ^= zobrist::tile(position, placed->getPrototype().index, placed->getRotation());
+
+   placement.new_empty_begin = empty_locations_.size();
+   placements_.push_back(placement);
+
+   // indexed by Tile::Side
+   const glm::ivec2 sides[] = { glm::ivec2(1, 0), glm::ivec2(0, 1), glm::ivec2(-1, 0), glm::ivec2(0, -1) };
+   for (int i = 0; i < 4; ++i)
+      makeEmpty(position + sides[i]);
+
+   // makeEmpty() may have allocated new chunks, but never moves existing ones
+   Chunk& chunk = *findChunk(position);
+   unsigned char signature = placed->getEdgeSignature();
+   for (int i = 0; i < 4; ++i)
+   {
+      Cell& neighbor = *findNeighbor(position, chunk, sides[i]);
+
+      if (neighbor.empty_index >= 0)
+      {
+         // the neighbor's opposite side must match this side
+         int shift = 2 * ((i + 2) % 4);
+         removeFromBucket(neighbor);
+         neighbor.constraints |= (((signature >> (2 * i)) & 0x3) + 1) << shift;
+         addToBucket(position + sides[i], neighbor);
+      }
 
-      default:
-         return false;
+      placed->closeSide(static_cast<Tile::Side>(i), neighbor.tile.get());
    }
+
+   const glm::ivec2 diagonals[] = { glm::ivec2(1, 1), glm::ivec2(1, -1), glm::ivec2(-1, 1), glm::ivec2(-1, -1) };
+   for (int i = 0; i < 4; ++i)
+   {
+      Cell* diagonal = findNeighbor(position, chunk, diagonals[i]);
+      if (diagonal)
+         placed->closeDiagonal(diagonal->tile.get());
+   }
+
+   return true;
 }
 
-bool Board::usingNewTile(const Tile& tile)
+// Each step of placeTileAt() is reversed, in reverse order.  The order of
+// empty_locations_ is restored exactly; the order of locations within
+// buckets is not.
+std::unique_ptr<Tile> Board::undoPlacement()
 {
-   bool at_least_one_placeable_location(false);
+   std::unique_ptr<Tile> tile;
+   if (placements_.empty())
+      return tile;
 
-   next_empty_location_ = empty_locations_.begin();
+   Placement placement = placements_.back();
+   placements_.pop_back();
+   const glm::ivec2& position = placement.position;
 
-   for (auto i(empty_locations_.begin()), end(empty_locations_.end()); i != end; ++i)
+   // reverts any joins, closed edges, followers, and scoring since the tile
+   // was placed.
+   regions_.undo(placement.regions_mark);
+
+   Chunk& chunk = *findChunk(position);
+   Cell& cell = *findCell(position);
+   Tile* placed = cell.tile.get();
+
+   const glm::ivec2 diagonals[] = { glm::ivec2(1, 1), glm::ivec2(1, -1), glm::ivec2(-1, 1), glm::ivec2(-1, -1) };
+   for (int i = 3; i >= 0; --i)
+   {
+      Cell* diagonal = findNeighbor(position, chunk, diagonals[i]);
+      if (diagonal)
+         placed->openDiagonal(diagonal->tile.get());
+   }
+
+   const glm::ivec2 sides[] = { glm::ivec2(1, 0), glm::ivec2(0, 1), glm::ivec2(-1, 0), glm::ivec2(0, -1) };
+   for (int i = 3; i >= 0; --i)
    {
-      Tile* current = getTileAt(*i);
-      if (checkTilePlaceable(*i, current, tile) != 0)
-         at_least_one_placeable_location = true;
+      Cell& neighbor = *findNeighbor(position, chunk, sides[i]);
+
+      placed->openSide(static_cast<Tile::Side>(i), neighbor.tile.get());
+
+      if (neighbor.empty_index >= 0)
+      {
+         removeFromBucket(neighbor);
+         neighbor.constraints &= ~(0x3 << (2 * ((i + 2) % 4)));
+
+         // locations which only became empty because of this tile are
+         // removed from empty_locations_ below.
+         if (static_cast<size_t>(neighbor.empty_index) < placement.new_empty_begin)
+            addToBucket(position + sides[i], neighbor);
+      }
+   }
+
+   while (empty_locations_.size() > placement.new_empty_begin)
+   {
+      findCell(empty_locations_.back())->empty_index = -1;
+      empty_locations_.pop_back();
+   }
+
+   // put position back where it was in empty_locations_, moving the location
+   // that was swapped into its place back to the end.
+   size_t index = placement.empty_index;
+   if (index == empty_locations_.size())
+      empty_locations_.push_back(position);
+   else
+   {
+      glm::ivec2 moved(empty_locations_[index]);
+      findCell(moved)->empty_index = empty_locations_.size();
+      empty_locations_.push_back(moved);
+      empty_locations_[index] = position;
    }
+   cell.empty_index = index;
+   addToBucket(position, cell);
+
+   next_empty_location_ = 0;
+   fitting_rotations_valid_ = false;
 
-   return at_least_one_placeable_location;
+   hash_ ^= zobrist::tile(position, placed->getPrototype().index, placed->getRotation());
+   placed_tiles_.pop_back();
+   tile = std::move(cell.tile);
+   tile->lift();
+
+   return tile;
 }
 
-void Board::tileRotated(const Tile& tile)
+bool Board::usingNewTile(const Tile& tile)
 {
-   next_empty_location_ = empty_locations_.begin();
+   updateFittingRotations(tile);
+   updateBucketTypes(tile);
 
-   for (auto i(empty_locations_.begin()), end(empty_locations_.end()); i != end; ++i)
+   for (auto i(active_buckets_.begin()), end(active_buckets_.end()); i != end; ++i)
    {
-      Tile* current = getTileAt(*i);
-      if (current->getType() == Tile::TYPE_EMPTY_NOT_PLACEABLE)
-         continue;
-
-      checkTilePlaceable(*i, current, tile);
+      if (buckets_[*i].fitting_rotations != 0)
+         return true;
    }
+
+   return false;
+}
+
+void Board::tileRotated(const Tile& tile)
+{
+   updateFittingRotations(tile);
+   updateBucketTypes(tile);
 }
 
+unsigned char Board::getFittingRotations(const glm::ivec2& position, const Tile& tile)
+{
+   Cell* cell = findCell(position);
+   if (cell == nullptr || cell->empty_index < 0)
+      return 0;
+
+   updateFittingRotations(tile);
+   return buckets_[cell->constraints].fitting_rotations;
+}
 
 const glm::ivec2* Board::getNextPlaceableLocation()
 {
-   if (next_empty_location_ == empty_locations_.end())
-      next_empty_location_ = empty_locations_.begin();
+   size_t count = empty_locations_.size();
+
+   for (size_t n = 0; n < count; ++n)
+   {
+      if (next_empty_location_ >= count)
+         next_empty_location_ = 0;
+
+      const glm::ivec2& location = empty_locations_[next_empty_location_];
+      ++next_empty_location_;
+
+      if (buckets_[findCell(location)->constraints].type == Tile::TYPE_EMPTY_PLACEABLE)
+         return &location;
+   }
+
+   // if there are no placeable locations
+   return nullptr;
+}
+
+size_t Board::getMoves(const Tile& tile, const Player& player, Move* moves, size_t max_moves)
+{
+   updateFittingRotations(tile);
+
+   bool idle_follower = player.getIdleFollowerCount() > 0;
+   size_t count = 0;
+   size_t feature_count = tile.getFeatureCount();
 
-   auto start = next_empty_location_;
+   // indexed by Tile::Side
+   const glm::ivec2 sides[] = { glm::ivec2(1, 0), glm::ivec2(0, 1), glm::ivec2(-1, 0), glm::ivec2(0, -1) };
 
-   do
+   for (auto i(empty_locations_.begin()), end(empty_locations_.end()); i != end; ++i)
    {
-      if (next_empty_location_ != empty_locations_.end())
+      const glm::ivec2& position = *i;
+      Chunk& chunk = *findChunk(position);
+      unsigned char rotations = buckets_[findCell(position)->constraints].fitting_rotations;
+
+      if (rotations == 0)
+         continue;
+
+      bool followers = idle_follower || completesCloister(position, chunk, player);
+
+      Tile* neighbors[4];
+      for (int side = 0; side < 4; ++side)
+      {
+         Cell* neighbor = findNeighbor(position, chunk, sides[side]);
+         neighbors[side] = neighbor ? neighbor->tile.get() : nullptr;
+      }
+
+      for (int r = 0; r < 4; ++r)
       {
-         const glm::ivec2& location = *next_empty_location_;
-         Tile* tile = getTileAt(location);
+         if ((rotations & (1 << r)) == 0)
+            continue;
+
+         Tile::Rotation rotation = static_cast<Tile::Rotation>(r);
 
-         if (tile->getType() == Tile::TYPE_EMPTY_PLACEABLE)
+         if (count < max_moves)
+            moves[count] = Move(position, rotation);
+         ++count;
+
+         if (!followers)
+            continue;
+
+         unsigned int occupied = getOccupiedFeatures(tile, rotation, neighbors);
+         for (size_t f = 0; f < feature_count; ++f)
          {
-            ++next_empty_location_;
-            return &location;
+            if (occupied & (1 << f))
+               continue;
+
+            if (count < max_moves)
+               moves[count] = Move(position, rotation, f);
+            ++count;
          }
+      }
+   }
+
+   return count;
+}
+
+// Each feature on a side of tile will be joined with the feature on the
+// facing side of the neighbor.  A region can reach tile more than once
+// (e.g. a farm surrounding a city), so two of tile's features which join the
+// same region are joined to each other too, and occupation spreads between
+// them until nothing changes.
+unsigned int Board::getOccupiedFeatures(const Tile& tile, Tile::Rotation rotation, Tile* const neighbors[4])
+{
+   enum { MAX_LINKS = 16 };
+
+   int features[MAX_LINKS];   // index of the feature of tile
+   int roots[MAX_LINKS];      // the region it will join
+   bool occupied_roots[MAX_LINKS];
+   int links = 0;
+
+   for (int side = 0; side < 4; ++side)
+   {
+      Tile* neighbor = neighbors[side];
+      if (neighbor == nullptr)
+         continue;
+
+      const TileEdge& edge = tile.getEdge(static_cast<Tile::Side>(side), rotation);
+      const TileEdge& neighbor_edge = neighbor->getEdge(static_cast<Tile::Side>((side + 2) % 4));
 
-         ++next_empty_location_;
+      const features::Feature* pairs[3][2];
+      int pair_count = 0;
+      switch (edge.type)
+      {
+         case TileEdge::TYPE_CITY:
+            pairs[0][0] = edge.city;      pairs[0][1] = neighbor_edge.city;
+            pair_count = 1;
+            break;
+
+         case TileEdge::TYPE_ROAD:
+            pairs[0][0] = edge.road;      pairs[0][1] = neighbor_edge.road;
+            pairs[1][0] = edge.cw_farm;   pairs[1][1] = neighbor_edge.ccw_farm;
+            pairs[2][0] = edge.ccw_farm;  pairs[2][1] = neighbor_edge.cw_farm;
+            pair_count = 3;
+            break;
+
+         default:
+            pairs[0][0] = edge.farm;      pairs[0][1] = neighbor_edge.farm;
+            pair_count = 1;
+            break;
       }
 
-      if (next_empty_location_ == empty_locations_.end())
-         next_empty_location_ = empty_locations_.begin();
+      for (int p = 0; p < pair_count && links < MAX_LINKS; ++p)
+      {
+         int root = regions_.find(pairs[p][1]->getRegion());
+         features[links] = tile.getFeatureIndex(*pairs[p][0]);
+         roots[links] = root;
+         occupied_roots[links] = !regions_.getFollowers(root).empty();
+         ++links;
+      }
+   }
 
-   } while (next_empty_location_ != start);
+   unsigned int occupied = 0;
+   bool changed = true;
+   while (changed)
+   {
+      changed = false;
 
-   // if there are no placeable locations
-   return nullptr;
+      for (int i = 0; i < links; ++i)
+      {
+         unsigned int bit = 1 << features[i];
+         if (occupied_roots[i] && (occupied & bit) == 0)
+         {
+            occupied |= bit;
+            changed = true;
+         }
+         else if (!occupied_roots[i] && (occupied & bit) != 0)
+         {
+            for (int j = 0; j < links; ++j)
+            {
+               if (roots[j] == roots[i])
+                  occupied_roots[j] = true;
+            }
+            changed = true;
+         }
+      }
+   }
+
+   return occupied;
 }
 
-// returns 0 if tile is not placeable at this location, 1 if it is placeable, but must be rotated,
-// and 2 if it is placeable right now.  Also updates current tile's type at that location.
-int Board::checkTilePlaceable(const glm::ivec2& position, Tile* current, const Tile& tile)
+bool Board::completesCloister(const glm::ivec2& position, Chunk& chunk, const Player& player)
 {
-   Tile* north = getTileAt(position + glm::ivec2(1, 0));
-   Tile* south = getTileAt(position - glm::ivec2(1, 0));
-   Tile* east = getTileAt(position + glm::ivec2(0, 1));
-   Tile* west = getTileAt(position - glm::ivec2(0, 1));
+   const glm::ivec2 offsets[] = { glm::ivec2(1, 0), glm::ivec2(0, 1), glm::ivec2(-1, 0), glm::ivec2(0, -1),
+                                  glm::ivec2(1, 1), glm::ivec2(1, -1), glm::ivec2(-1, 1), glm::ivec2(-1, -1) };
+   for (int i = 0; i < 8; ++i)
+   {
+      Cell* cell = findNeighbor(position, chunk, offsets[i]);
+      if (cell == nullptr || !cell->tile)
+         continue;
 
-   current->setType(Tile::TYPE_EMPTY_NOT_PLACEABLE);
+      Tile& tile = *cell->tile;
+      features::Feature& feature = *tile.getFeature(tile.getFeatureCount() - 1);
+      if (!feature.isCloister() || static_cast<features::Cloister&>(feature).getTileCount() != 8)
+         continue;
 
-   // try all 4 rotations of the tile
-   for (int i = 0; i < 4; ++i)
+      const std::vector<Follower*>& followers = regions_.getFollowers(feature.getRegion());
+      for (auto f(followers.begin()), end(followers.end()); f != end; ++f)
+      {
+         if ((*f)->getOwner() == &player)
+            return true;
+      }
+   }
+
+   return false;
+}
+
+void Board::updateFittingRotations(const Tile& tile)
+{
+   unsigned char signature = tile.getEdgeSignature(Tile::ROTATION_NONE);
+   if (fitting_rotations_valid_ && fitting_rotations_signature_ == signature)
+      return;
+
+   for (auto i(active_buckets_.begin()), end(active_buckets_.end()); i != end; ++i)
    {
-      if ((north == nullptr || north->getType() != Tile::TYPE_PLACED ||
-           tile.getEdge(static_cast<Tile::Side>(i + Tile::SIDE_NORTH)).type == 
-           north->getEdge(Tile::SIDE_SOUTH).type) &&
-
-          (south == nullptr || south->getType() != Tile::TYPE_PLACED ||
-           tile.getEdge(static_cast<Tile::Side>(i + Tile::SIDE_SOUTH)).type ==
-           south->getEdge(Tile::SIDE_NORTH).type) &&
-
-          (east == nullptr || east->getType() != Tile::TYPE_PLACED ||
-           tile.getEdge(static_cast<Tile::Side>(i + Tile::SIDE_EAST)).type == 
-           east->getEdge(Tile::SIDE_WEST).type) &&
-          
-          (west == nullptr || west->getType() != Tile::TYPE_PLACED ||
-           tile.getEdge(static_cast<Tile::Side>(i + Tile::SIDE_WEST)).type ==
-           west->getEdge(Tile::SIDE_EAST).type))
+      Bucket& bucket = buckets_[*i];
+      bucket.fitting_rotations = 0;
+
+      for (int r = 0; r < 4; ++r)
       {
-         current->setType(i == 0 ? Tile::TYPE_EMPTY_PLACEABLE : Tile::TYPE_EMPTY_PLACEABLE_IF_ROTATED);
-         return i == 0 ? 2 : 1;
+         if ((tile.getEdgeSignature(static_cast<Tile::Rotation>(r)) & bucket.edge_mask) == bucket.required_edges)
+            bucket.fitting_rotations |= 1 << r;
       }
    }
-   return 0;
+
+   fitting_rotations_valid_ = true;
+   fitting_rotations_signature_ = signature;
+}
+
+void Board::updateBucketTypes(const Tile& tile)
+{
+   next_empty_location_ = 0;
+
+   unsigned char current_rotation = 1 << tile.getRotation();
+   for (auto i(active_buckets_.begin()), end(active_buckets_.end()); i != end; ++i)
+   {
+      Bucket& bucket = buckets_[*i];
+
+      if (bucket.fitting_rotations & current_rotation)
+         bucket.type = Tile::TYPE_EMPTY_PLACEABLE;
+      else if (bucket.fitting_rotations != 0)
+         bucket.type = Tile::TYPE_EMPTY_PLACEABLE_IF_ROTATED;
+      else
+         bucket.type = Tile::TYPE_EMPTY_NOT_PLACEABLE;
+   }
 }
 
 void Board::scoreAllTiles()
 {
-   for (auto i(board_.begin()), end(board_.end()); i != end; ++i)
+   for (auto i(placed_tiles_.begin()), end(placed_tiles_.end()); i != end; ++i)
    {
-      for (int j = 0; j < i->second->getFeatureCount(); ++j)
+      for (size_t j = 0; j < (*i)->getFeatureCount(); ++j)
       {
-         i->second->getFeature(j).lock()->score();
+         (*i)->getFeature(j)->score();
       }
    }
 }
 
-void Board::draw() const
+const std::vector<Tile*>& Board::getPlacedTiles() const
+{
+   return placed_tiles_;
+}
+
+const std::vector<glm::ivec2>& Board::getEmptyLocations() const
+{
+   return empty_locations_;
+}
+
+unsigned long long Board::getHash() const
+{
+   return hash_;
+}
+
+features::RegionStore& Board::getRegions()
+{
+   return regions_;
+}
+
+const features::RegionStore& Board::getRegions() const
+{
+   return regions_;
+}
+
+Board::Chunk* Board::findChunk(const glm::ivec2& position) const
+{
+   glm::ivec2 chunk_coords(position.x >> CHUNK_SIZE_BITS, position.y >> CHUNK_SIZE_BITS);
+   auto i(chunks_.find(chunk_coords));
+   return i == chunks_.end() ? nullptr : i->second.get();
+}
+
+Board::Cell* Board::findCell(const glm::ivec2& position) const
+{
+   Chunk* chunk = findChunk(position);
+   if (chunk == nullptr)
+      return nullptr;
+
+   return &chunk->cells[((position.y & CHUNK_MASK) << CHUNK_SIZE_BITS) | (position.x & CHUNK_MASK)];
+}
+
+Board::Cell& Board::getCell(const glm::ivec2& position)
 {
-   /*
-   gfx::Texture::disableAny();
-   glBegin(GL_LINES);
-   glColor3f(1,0,0); glVertex3f(0,0.1,0); glVertex3f(10, 0.1, 0);
-   glColor3f(0,1,0); glVertex3f(0,0.1,0); glVertex3f(0, 10, 0);
-   glColor3f(0,0,1); glVertex3f(0,0.1,0); glVertex3f(0, 0.1, 10);
-   glEnd();*/
-
-   for (auto i(board_.begin()), end(board_.end()); i != end; ++i)
+   glm::ivec2 chunk_coords(position.x >> CHUNK_SIZE_BITS, position.y >> CHUNK_SIZE_BITS);
+   std::unique_ptr<Chunk>& chunk = chunks_[chunk_coords];
+
+   if (!chunk)
+      chunk.reset(new Chunk());
+
+   return chunk->cells[((position.y & CHUNK_MASK) << CHUNK_SIZE_BITS) | (position.x & CHUNK_MASK)];
+}
+
+Board::Cell* Board::findNeighbor(const glm::ivec2& position, Chunk& chunk, const glm::ivec2& offset) const
+{
+   int x = (position.x & CHUNK_MASK) + offset.x;
+   int y = (position.y & CHUNK_MASK) + offset.y;
+
+   if (x >= 0 && x < CHUNK_SIZE && y >= 0 && y < CHUNK_SIZE)
+      return &chunk.cells[(y << CHUNK_SIZE_BITS) | x];
+
+   return findCell(position + offset);
+}
+
+void Board::addToBucket(const glm::ivec2& position, Cell& cell)
+{
+   Bucket& bucket = buckets_[cell.constraints];
+
+   if (bucket.locations.empty())
    {
-      if (i->second && i->second->getType() == Tile::TYPE_PLACED)
-         i->second->draw();
+      active_buckets_.push_back(cell.constraints);
+
+      // a new bucket hasn't been checked against the memoized tile
+      fitting_rotations_valid_ = false;
    }
+
+   cell.bucket_index = bucket.locations.size();
+   bucket.locations.push_back(position);
 }
 
-void Board::drawEmpyTiles() const
+void Board::removeFromBucket(Cell& cell)
 {
-   for (auto i(empty_locations_.begin()), end(empty_locations_.end()); i != end; ++i)
+   if (cell.bucket_index < 0)
+      return;
+
+   Bucket& bucket = buckets_[cell.constraints];
+
+   // swap the last location into the removed location's place
+   size_t index = cell.bucket_index;
+   if (index != bucket.locations.size() - 1)
+   {
+      const glm::ivec2& last = bucket.locations.back();
+      findCell(last)->bucket_index = index;
+      bucket.locations[index] = last;
+   }
+   bucket.locations.pop_back();
+   cell.bucket_index = -1;
+
+   if (bucket.locations.empty())
    {
-      Tile* tile = getTileAt(*i);
-      if (tile)
-         tile->draw();
+      for (auto i(active_buckets_.begin()), end(active_buckets_.end()); i != end; ++i)
+      {
+         if (*i == cell.constraints)
+         {
+            *i = active_buckets_.back();
+            active_buckets_.pop_back();
+            break;
+         }
+      }
    }
 }
 
-Tile* Board::makeEmpty(const glm::ivec2& position)
+void Board::makeEmpty(const glm::ivec2& position)
 {
-   std::unique_ptr<Tile>& ptr = board_[position];
+   Cell& cell = getCell(position);
 
-   if (!ptr)
+   if (!cell.tile && cell.empty_index < 0)
    {
-      ptr.reset(new Tile(asset_mgr_, Tile::TYPE_EMPTY_PLACEABLE));
-      ptr->setPosition(glm::vec3(position.x, 0, position.y));
-      empty_locations_.insert(position);
-      next_empty_location_ = empty_locations_.begin();
+      cell.empty_index = empty_locations_.size();
+      empty_locations_.push_back(position);
+      next_empty_location_ = 0;
    }
-
-   return ptr.get();
 }
 
 } // namespace carcassonne
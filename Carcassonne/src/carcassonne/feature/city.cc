@@ -21,32 +21,19 @@
 //
 // Represents a city.  Cities are objects which can span multiple tiles.
 
-#include "carcassonne\features\city.h"
+#include "carcassonne/features/city.h"
 
-#include <map>
-
-#include "carcassonne\asset_manager.h"
-#include "carcassonne\db\db.h"
-#include "carcassonne\db\stmt.h"
-#include "carcassonne\tile.h"
-#include "carcassonne\player.h"
+#include "carcassonne/tile.h"
+#include "carcassonne/features/region_store.h"
 
 
 namespace carcassonne {
 namespace features {
 
-City::City(AssetManager& asset_mgr, int id, int pennants, Tile& tile)
-   : pennants_(pennants)
+City::City(const Follower& placeholder, int pennants, Tile& tile)
+   : Feature(placeholder, tile),
+     pennants_(pennants)
 {
-   follower_placeholder_.reset(new Follower(asset_mgr, id));
-   tiles_.push_back(&tile);
-}
-
-City::City(const City& other, Tile& tile)
-   : Feature(other),
-     pennants_(other.pennants_)
-{
-   tiles_.push_back(&tile);
 }
 
 City::~City()
@@ -58,152 +45,46 @@ Feature::Type City::getType() const
    return TYPE_CITY;
 }
 
-// for each TileEdge in each tile in tiles_, if TileEdge::open is true,
-// TileEdge::type is TileEdge::TYPE_CITY, and TileEdge::city is (this),
-// then return false.
+// A city is complete when none of the tile edges it covers are open.  The
+// region keeps a count of open edges (see Tile::closeSide()).
 bool City::isComplete() const
 {
-   for (auto i(tiles_.begin()), end(tiles_.end()); i != end; ++i)
-   {
-      for (int j = Tile::SIDE_NORTH; j <= Tile::SIDE_WEST; ++j)
-      {
-         const TileEdge& edge = (*i)->getEdge(static_cast<Tile::Side>(j));
-         if(edge.open && edge.type == TileEdge::TYPE_CITY && edge.city == this)
-            return false;
-      }
-   }
- return true;
+   return regions_->getOpenEdges(region_) == 0;
 }
 
-// Let 'pts' be tiles_.size() + pennants_.  If isComplete(), double 'pts'.
-// Iterate through the followers in this city.  Create a map of players to
-// number of followers for that player, keeping track of the highest number
-// of followers.  When finished iterating, find all players in map who have
-// that number of followers and increase each player's score by 'pts.'
-// Finally, return all followers to idle state.
+// Let 'pts' be the number of tiles in the region plus its pennants.  If
+// isComplete(), double 'pts' and award them to the players with the most
+// followers in the region.
 void City::score()
 {
-   if (followers_.empty())
+   if (regions_->getFollowers(region_).empty())
       return;
 
    int points = 0;
-   points = tiles_.size() + pennants_;
+   points = regions_->getTileCount(region_) + regions_->getPennants(region_);
    if (isComplete())
    {
       points *= 2;
    }
 
-   std::map<Player*, int> players;
-   int mostFollowers= 0;
-   std::vector<Player*> players_with_most_followers;
-
-   for (auto i(followers_.begin()), end(followers_.end()); i != end; ++i)
-   {
-      Follower* f = *i;
-      Player* owner = f->getOwner();
-      f->setIdle(true);
-      int& count = players[owner];
-
-      ++count;
-
-      if (count > mostFollowers)
-      {
-         mostFollowers = count;
-         players_with_most_followers.clear();
-         players_with_most_followers.push_back(owner);
-      }
-      else if (count == mostFollowers)
-      {
-         //they are eating bacon and dancing
-         players_with_most_followers.push_back(owner);
-      }
-   }
-   followers_.clear();
-   //players_with_most_followers now has all players who should receive 'points' points.
-
-   for (auto i(players_with_most_followers.begin()), 
-             end(players_with_most_followers.end()); i != end; ++i)
-   {
-      Player* p = *i;
-      p->scorePoints(points);
-   }
-      
+   awardPoints(points);
 }
 
-// merges this city with another city (due to a tile being placed connecting
-// the cities).
-//
-// If this == &other then the cities are already merged, and nothing needs
-// to be done.
-//
-// Otherwise, the city which covers the most tiles (or the city passed as the
-// function parameter if both cities cover the same number of tiles) will be
-// designated as the surviving city.  The smaller city will be designated as
-// the dying city.
-//
-// Add the dying city's pennants_ to the surviving city's.
-//
-// All followers from the dying city's followers_ vector will be placed in
-// the surviving city's followers_ vector.
-//
-// If neither city has any followers yet, and the surviving city is (*this),
-// follower_placeholder_ will be set to std::move(other.follower_placeholder_).
-// Therefore when placing a tile with a city, the already placed neighbor
-// cities should be join()ed to the new tile's city, i.e.
-// old_tile_city.join(new_tile_city);  (note: those are not real variable
-// names).  This is accomplished by calling Tile::closeSide() on the existing
-// tile before the new tile.
-// 
-// Finally, the dying city will call Tile::replaceCity() on each of the tiles
-// it covers so that they now refer to the surviving city.  This should cause
-// all shared_ptrs to the dying city to go away, and the dying city will be
-// destroyed.
-void City::join(City& other)
+// The region's pennants are the sum of the pennants of all its cities.
+// Since the tile has just been placed, every edge this city covers is
+// still open.
+void City::addToRegion(RegionStore& regions)
 {
-   if (this == &other)
-   {
-      return;
-   }
-
-   std::shared_ptr<Feature> lock1(shared_from_this());
-   std::shared_ptr<Feature> lock2(other.shared_from_this());
-
-   City* survivor;
-   City* victim;
-   if (tiles_.size() > other.tiles_.size())
-   {
-      survivor = this;
-      victim = &other;
-   }
-   else 
-   {
-      survivor = &other;
-      victim = this;
-   }
-
-   survivor->pennants_ += victim->pennants_;
-   victim->pennants_ = 0;
-
-   survivor->followers_.insert(survivor->followers_.end(),
-                               victim->followers_.begin(),
-                               victim->followers_.end());
-   victim->followers_.clear();
-
-   if (survivor->followers_.empty())
+   int open_edges = 0;
+   for (int j = Tile::SIDE_NORTH; j <= Tile::SIDE_WEST; ++j)
    {
-      if (survivor == this)
-         survivor->follower_placeholder_ = std::move(other.follower_placeholder_);
+      const TileEdge& edge = tile_->getEdge(static_cast<Tile::Side>(j));
+      if (edge.type == TileEdge::TYPE_CITY && edge.city == this)
+         ++open_edges;
    }
-   else
-      survivor->follower_placeholder_.reset();
 
-   for (auto i(victim->tiles_.begin()), end(victim->tiles_.end()); i!= end; ++i)
-   {
-      Tile* t = *i;
-      survivor->tiles_.push_back(t);
-      t->replaceCity(*victim, *survivor);
-   }
-   victim->tiles_.clear();
+   regions_ = &regions;
+   region_ = regions.add(*this, pennants_, open_edges);
 }
 
 } // namespace carcassonne::features
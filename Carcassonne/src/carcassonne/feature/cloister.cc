@@ -24,24 +24,19 @@
 // Represents a cloister.  A cloister is only only on one tile, but scores 
 // points based on the 8 neighboring tiles as well.
 
-#include "carcassonne\features\cloister.h"
+#include "carcassonne/features/cloister.h"
 
 #include <algorithm>
 
-#include "carcassonne\player.h"
-#include "carcassonne\follower.h"
+#include "carcassonne/player.h"
+#include "carcassonne/follower.h"
+#include "carcassonne/features/region_store.h"
 
 namespace carcassonne {
 namespace features {
 
-Cloister::Cloister(AssetManager& asset_mgr, int id, Tile& tile)
-{
-   follower_placeholder_.reset(new Follower(asset_mgr, id));
-   tiles_.push_back(&tile);
-}
-
-Cloister::Cloister(const Cloister& other, Tile& tile)
-   : Feature(other)
+Cloister::Cloister(const Follower& placeholder, Tile& tile)
+   : Feature(placeholder, tile)
 {
    tiles_.push_back(&tile);
 }
@@ -60,22 +55,19 @@ bool Cloister::isComplete()const
    return tiles_.size() == 9;
 }
 
-// Award tiles_.size() points to the owner of the first follower in
-// followers_, if any (cloisters can only ever support one follower).
-// Finally, return all followers to idle state.
+// Award tiles_.size() points to the owner of the follower in the cloister,
+// if any (cloisters can only ever support one follower).  Finally, return
+// the follower to idle state.
 void Cloister::score()
 {
-   int points = 0;
-   points = tiles_.size();
-   
-   if (!followers_.empty())
-   {
-      Follower* f = followers_.front();
-      f->getOwner()->scorePoints(points);
-      f->setIdle(true);
-      followers_.clear();
-   }
+   awardPoints(tiles_.size());
+}
+
+size_t Cloister::getTileCount() const
+{
+   return tiles_.size();
 }
+
 //adds cloister tiles to the pile
 void Cloister::addTile(Tile& tile)
 {
@@ -84,5 +76,13 @@ void Cloister::addTile(Tile& tile)
       tiles_.push_back(&tile);
 }
 
+//removes a tile which was taken back off the board
+void Cloister::removeTile(Tile& tile)
+{
+   auto i(std::find(tiles_.begin(), tiles_.end(), &tile));
+   if (i != tiles_.end() && *i != tile_)
+      tiles_.erase(i);
+}
+
 } // namespace carcassonne::features
-} // namespace carcassonne
\ No newline at end of file
+} // namespace carcassonne
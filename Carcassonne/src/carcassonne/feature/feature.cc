@@ -23,24 +23,23 @@
 //
 // Base class for cities, cloisters, farms, and roads.
 
-#include "carcassonne\features\feature.h"
+#include "carcassonne/features/feature.h"
 
-#include "carcassonne\tile.h"
+#include "carcassonne/tile.h"
+#include "carcassonne/player.h"
+#include "carcassonne/features/region_store.h"
 
 namespace carcassonne {
 namespace features {
 
-Feature::Feature()
+Feature::Feature(const Follower& placeholder, Tile& tile)
+   : tile_(&tile),
+     regions_(nullptr),
+     region_(-1),
+     follower_placeholder_(&placeholder)
 {
 }
 
-// copies an existing feature, without adding tiles or followers
-Feature::Feature(const Feature& other)
-{
-   if (other.follower_placeholder_)
-      follower_placeholder_.reset(new Follower(*other.follower_placeholder_));
-}
-
 Feature::~Feature()
 {
 }
@@ -70,37 +69,72 @@ bool Feature::isRoad() const
 //tile displaying where a follower may be placed
 bool Feature::hasPlaceholder() const
 {
-   return follower_placeholder_;
+   if (!follower_placeholder_)
+      return false;
+
+   return regions_ == nullptr || regions_->getFollowers(region_).empty();
 }
 
 const Follower* Feature::getPlaceholder() const
 {
-   return follower_placeholder_.get();
+   return follower_placeholder_;
 }
 
-void Feature::drawPlaceholder() const
+void Feature::placeFollower(Follower& follower, const Tile& relative_to)
 {
-   if (follower_placeholder_)
-      follower_placeholder_->draw();
+   if (!hasPlaceholder() || regions_ == nullptr)
+      return;
+
+   regions_->addFollower(region_, follower);
+   follower.setIdle(false);
+   follower.setFloating(false);
+   follower.setOrientation(*follower_placeholder_, relative_to);
 }
 
-void Feature::setPlaceholderColor(const glm::vec4& color)
+void Feature::addToRegion(RegionStore& regions)
 {
-   if (follower_placeholder_)
-      follower_placeholder_->setColor(color);
+   regions_ = &regions;
+   region_ = regions.add(*this, 0, 0);
 }
 
-void Feature::placeFollower(Follower& follower, const Tile& relative_to)
+void Feature::removeFromRegion()
 {
-   if (!follower_placeholder_)
-      return;
+   regions_ = nullptr;
+   region_ = -1;
+}
 
-   follower.setIdle(false);
-   follower.setFloating(false);
-   follower.setOrientation(*follower_placeholder_, relative_to);
-   followers_.push_back(&follower);
-   follower_placeholder_.reset();
+// If both features are already in the same region, nothing happens.
+// Otherwise the smaller region's pennants, followers, and adjacent cities
+// are moved to the larger region.  See RegionStore::join().
+void Feature::join(Feature& other)
+{
+   regions_->join(region_, other.region_);
+}
+
+// Each edge is closed exactly once, either when this feature's tile is
+// placed next to an existing tile, or when a tile is placed next to it later.
+void Feature::closeEdge()
+{
+   regions_->closeEdge(region_);
 }
 
+int Feature::getRegion() const
+{
+   return region_;
+}
+
+Tile& Feature::getTile() const
+{
+   return *tile_;
 }
-}
\ No newline at end of file
+
+// Awards points to the player(s) with the most followers in this feature's
+// region, and returns all of the region's followers to idle state.  See
+// RegionStore::score().
+void Feature::awardPoints(int points)
+{
+   regions_->score(region_, points);
+}
+
+} // namespace carcassonne::features
+} // namespace carcassonne
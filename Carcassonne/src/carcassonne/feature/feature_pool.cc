@@ -0,0 +1,88 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/features/feature_pool.h
+//
+// Owns the features of every tile drawn from a pile.  Each type of feature
+// is stored contiguously in its own Pool, and features are referred to by
+// 32-bit handles: the feature's Feature::Type in the top 2 bits and its
+// index in that type's pool in the rest.  All the features from one game are
+// destroyed together when the pool is destroyed.
+
+#include "carcassonne/features/feature_pool.h"
+
+namespace carcassonne {
+namespace features {
+
+FeaturePool::FeaturePool()
+{
+}
+
+FeatureHandle FeaturePool::createCity(const Follower& placeholder, int pennants, Tile& tile)
+{
+   new (cities_.reserve()) City(placeholder, pennants, tile);
+   return cities_.add() | (static_cast<unsigned int>(Feature::TYPE_CITY) << HANDLE_TYPE_SHIFT);
+}
+
+FeatureHandle FeaturePool::createRoad(const Follower& placeholder, Tile& tile)
+{
+   new (roads_.reserve()) Road(placeholder, tile);
+   return roads_.add() | (static_cast<unsigned int>(Feature::TYPE_ROAD) << HANDLE_TYPE_SHIFT);
+}
+
+FeatureHandle FeaturePool::createFarm(const Follower& placeholder, Tile& tile)
+{
+   new (farms_.reserve()) Farm(placeholder, tile);
+   return farms_.add() | (static_cast<unsigned int>(Feature::TYPE_FARM) << HANDLE_TYPE_SHIFT);
+}
+
+FeatureHandle FeaturePool::createCloister(const Follower& placeholder, Tile& tile)
+{
+   new (cloisters_.reserve()) Cloister(placeholder, tile);
+   return cloisters_.add() | (static_cast<unsigned int>(Feature::TYPE_CLOISTER) << HANDLE_TYPE_SHIFT);
+}
+
+Feature& FeaturePool::get(FeatureHandle handle) const
+{
+   unsigned int index = handle & HANDLE_INDEX_MASK;
+   switch (getType(handle))
+   {
+      case Feature::TYPE_CITY:
+         return cities_[index];
+
+      case Feature::TYPE_ROAD:
+         return roads_[index];
+
+      case Feature::TYPE_FARM:
+         return farms_[index];
+
+      default:
+         return cloisters_[index];
+   }
+}
+
+Feature::Type FeaturePool::getType(FeatureHandle handle)
+{
+   return static_cast<Feature::Type>(handle >> HANDLE_TYPE_SHIFT);
+}
+
+} // namespace carcassonne::features
+} // namespace carcassonne
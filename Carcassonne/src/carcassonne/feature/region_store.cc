@@ -0,0 +1,335 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/features/region_store.cc
+//
+// A disjoint-set (union-find) forest of feature regions.
+
+#include "carcassonne/features/region_store.h"
+
+#include <algorithm>
+#include <map>
+
+#include "carcassonne/player.h"
+
+namespace carcassonne {
+namespace features {
+
+RegionStore::RegionStore()
+{
+}
+
+int RegionStore::add(Feature& feature, int pennants, int open_edges)
+{
+   int id = nodes_.size();
+
+   nodes_.push_back(Node());
+   Node& node = nodes_.back();
+   node.parent = id;
+   node.next = id;
+   node.feature = &feature;
+   node.size = 1;
+   node.pennants = pennants;
+   node.open_edges = open_edges;
+
+   record(JournalEntry::TYPE_ADD, id);
+   return id;
+}
+
+// find the root, then point every node along the way directly at it
+// (path compression).
+int RegionStore::find(int node)
+{
+   int root = node;
+   while (nodes_[root].parent != root)
+      root = nodes_[root].parent;
+
+   while (nodes_[node].parent != root)
+   {
+      int parent = nodes_[node].parent;
+      record(JournalEntry::TYPE_PARENT, node, parent);
+      nodes_[node].parent = root;
+      node = parent;
+   }
+
+   return root;
+}
+
+int RegionStore::getRoot(int node) const
+{
+   while (nodes_[node].parent != node)
+      node = nodes_[node].parent;
+
+   return node;
+}
+
+size_t RegionStore::size() const
+{
+   return nodes_.size();
+}
+
+// The smaller region's root becomes a child of the larger region's root,
+// and its data is moved into the larger root.  Swapping the next pointers of
+// the two roots splices the two rings together.
+int RegionStore::join(int a, int b)
+{
+   int root = find(a);
+   int child = find(b);
+
+   if (root == child)
+      return root;
+
+   if (nodes_[root].size < nodes_[child].size)
+      std::swap(root, child);
+
+   Node& r = nodes_[root];
+   Node& c = nodes_[child];
+
+   record(JournalEntry::TYPE_JOIN, child, root, r.followers.size(), r.adjacent_cities.size());
+
+   c.parent = root;
+   r.size += c.size;
+   r.pennants += c.pennants;
+   r.open_edges += c.open_edges;
+
+   r.followers.insert(r.followers.end(), c.followers.begin(), c.followers.end());
+   c.followers.clear();
+
+   r.adjacent_cities.insert(r.adjacent_cities.end(), c.adjacent_cities.begin(), c.adjacent_cities.end());
+   c.adjacent_cities.clear();
+
+   std::swap(r.next, c.next);
+
+   return root;
+}
+
+Feature& RegionStore::getFeature(int node) const
+{
+   return *nodes_[node].feature;
+}
+
+int RegionStore::getNext(int node) const
+{
+   return nodes_[node].next;
+}
+
+int RegionStore::getTileCount(int node)
+{
+   return nodes_[find(node)].size;
+}
+
+int RegionStore::getPennants(int node)
+{
+   return nodes_[find(node)].pennants;
+}
+
+int RegionStore::getOpenEdges(int node)
+{
+   return nodes_[find(node)].open_edges;
+}
+
+void RegionStore::closeEdge(int node)
+{
+   int root = find(node);
+   record(JournalEntry::TYPE_CLOSE_EDGE, root);
+   --nodes_[root].open_edges;
+}
+
+const std::vector<Follower*>& RegionStore::getFollowers(int node)
+{
+   return nodes_[find(node)].followers;
+}
+
+void RegionStore::addFollower(int node, Follower& follower)
+{
+   int root = find(node);
+   record(JournalEntry::TYPE_ADD_FOLLOWER, root, saved_followers_.size());
+   saved_followers_.push_back(std::make_pair(&follower, follower));
+   nodes_[root].followers.push_back(&follower);
+}
+
+// The state of each follower is saved before it is returned to idle, so
+// that undo() can put it back where it was.
+void RegionStore::score(int node, int points)
+{
+   int root = find(node);
+   std::vector<Follower*>& followers = nodes_[root].followers;
+
+   record(JournalEntry::TYPE_SCORE, root, saved_followers_.size(), followers.size(), points);
+   awardPoints(followers, points);
+
+   for (auto i(followers.begin()), end(followers.end()); i != end; ++i)
+   {
+      Follower* f = *i;
+      saved_followers_.push_back(std::make_pair(f, *f));
+      f->setIdle(true);
+   }
+   followers.clear();
+}
+
+void RegionStore::addAdjacentCity(int farm_node, int city_node)
+{
+   int root = find(farm_node);
+   record(JournalEntry::TYPE_ADD_CITY, root);
+   nodes_[root].adjacent_cities.push_back(city_node);
+}
+
+void RegionStore::getAdjacentCities(int farm_node, std::vector<int>& cities)
+{
+   cities.clear();
+
+   const std::vector<int>& adjacent = nodes_[find(farm_node)].adjacent_cities;
+   for (auto i(adjacent.begin()), end(adjacent.end()); i != end; ++i)
+      cities.push_back(find(*i));
+
+   std::sort(cities.begin(), cities.end());
+   cities.erase(std::unique(cities.begin(), cities.end()), cities.end());
+}
+
+size_t RegionStore::getUndoMark() const
+{
+   return journal_.size();
+}
+
+void RegionStore::undo(size_t mark)
+{
+   while (journal_.size() > mark)
+   {
+      const JournalEntry& entry = journal_.back();
+      Node& n = nodes_[entry.node];
+
+      switch (entry.type)
+      {
+         case JournalEntry::TYPE_ADD:
+            nodes_.pop_back();
+            break;
+
+         case JournalEntry::TYPE_PARENT:
+            n.parent = entry.a;
+            break;
+
+         // the child's size, pennants, and open edges are left untouched by
+         // join(), so they can just be subtracted back out of the root.
+         case JournalEntry::TYPE_JOIN:
+         {
+            Node& r = nodes_[entry.a];
+
+            std::swap(r.next, n.next);
+
+            n.adjacent_cities.assign(r.adjacent_cities.begin() + entry.c, r.adjacent_cities.end());
+            r.adjacent_cities.resize(entry.c);
+
+            n.followers.assign(r.followers.begin() + entry.b, r.followers.end());
+            r.followers.resize(entry.b);
+
+            r.open_edges -= n.open_edges;
+            r.pennants -= n.pennants;
+            r.size -= n.size;
+            n.parent = entry.node;
+            break;
+         }
+
+         case JournalEntry::TYPE_CLOSE_EDGE:
+            ++n.open_edges;
+            break;
+
+         case JournalEntry::TYPE_ADD_FOLLOWER:
+            n.followers.pop_back();
+            *saved_followers_.back().first = saved_followers_.back().second;
+            saved_followers_.pop_back();
+            break;
+
+         case JournalEntry::TYPE_ADD_CITY:
+            n.adjacent_cities.pop_back();
+            break;
+
+         case JournalEntry::TYPE_SCORE:
+         {
+            auto begin(saved_followers_.begin() + entry.a), end(begin + entry.b);
+            for (auto i(begin); i != end; ++i)
+            {
+               *i->first = i->second;
+               n.followers.push_back(i->first);
+               i->first->getOwner()->organizeIdleFollowers();
+            }
+            saved_followers_.erase(begin, end);
+
+            awardPoints(n.followers, -entry.c);
+            break;
+         }
+      }
+
+      journal_.pop_back();
+   }
+}
+
+void RegionStore::record(JournalEntry::Type type, int node, int a, int b, int c)
+{
+   JournalEntry entry;
+   entry.type = type;
+   entry.node = node;
+   entry.a = a;
+   entry.b = b;
+   entry.c = c;
+   journal_.push_back(entry);
+}
+
+// Create a map of players to number of followers for that player, keeping
+// track of the highest number of followers.  When finished iterating, find
+// all players in map who have that number of followers and increase each
+// player's score by points.
+void RegionStore::awardPoints(const std::vector<Follower*>& followers, int points)
+{
+   std::map<Player*, int> players;
+   int mostFollowers = 0;
+   std::vector<Player*> players_with_most_followers;
+
+   for (auto i(followers.begin()), end(followers.end()); i != end; ++i)
+   {
+      Player* owner = (*i)->getOwner();
+      int& count = players[owner];
+
+      ++count;
+
+      if (count > mostFollowers)
+      {
+         mostFollowers = count;
+         players_with_most_followers.clear();
+         players_with_most_followers.push_back(owner);
+      }
+      else if (count == mostFollowers)
+      {
+         //they are eating bacon and dancing
+         players_with_most_followers.push_back(owner);
+      }
+   }
+   //players_with_most_followers now has all players who should receive 'points' points.
+
+   for (auto i(players_with_most_followers.begin()),
+             end(players_with_most_followers.end()); i != end; ++i)
+   {
+      Player* p = *i;
+      p->scorePoints(points);
+   }
+}
+
+} // namespace carcassonne::features
+} // namespace carcassonne
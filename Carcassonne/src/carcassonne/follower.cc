@@ -27,21 +27,13 @@
 
 #include "carcassonne/follower.h"
 
-#include <glm/gtc/matrix_transform.hpp>
-
 #include "carcassonne/player.h"
 #include "carcassonne/tile.h"
-#include "carcassonne/asset_manager.h"
-#include "carcassonne/gfx/mesh.h"
-#include "carcassonne/db/db.h"
-#include "carcassonne/db/stmt.h"
 
 namespace carcassonne {
 
 Follower::Follower()
    : owner_(nullptr),
-     mesh_(nullptr),
-     color_(1,1,1,1),
      idle_(false),
      floating_(false),
      farming_(false),
@@ -51,13 +43,10 @@ Follower::Follower()
 
 Follower::Follower(const Follower& other)
    : owner_(other.owner_),
-     mesh_(other.mesh_),
-     color_(other.color_),
      idle_(other.idle_),
      floating_(other.floating_),
      position_(other.position_),
      farming_(other.farming_),
-     farming_transform_(other.farming_transform_),
      rotation_(other.rotation_)
 {
 }
@@ -65,62 +54,33 @@ Follower::Follower(const Follower& other)
 void Follower::operator=(const Follower& other)
 {
    owner_ = other.owner_;
-   mesh_ = other.mesh_;
-   color_ = other.color_;
    idle_ = other.idle_;
    floating_ = other.floating_;
    position_ = other.position_;
    farming_ = other.farming_;
-   farming_transform_ = other.farming_transform_;
    rotation_ = other.rotation_;
 }
 
-// load placeholder follower from db
-Follower::Follower(AssetManager& asset_mgr, int feature_id)
+// create a placeholder follower.  Placeholders are loaded along with the
+// rest of a tile's prototype (see Tileset).
+Follower::Follower(const glm::vec3& position, bool farming, float rotation)
    : owner_(nullptr),
-     mesh_(asset_mgr.getMesh("std-follower")),
-     color_(1,1,1,1),
      idle_(false),
-     floating_(false)
+     floating_(false),
+     position_(position),
+     farming_(farming),
+     rotation_(rotation)
 {
-   db::DB& db = asset_mgr.getDB();
-
-   db::Stmt s(db, "SELECT follower_orientation, follower_x, follower_z, follower_r "
-                  "FROM cc_tile_features "
-                  "WHERE id = ?");
-   s.bind(1, feature_id);
-   if (s.step())
-   {
-      farming_ = s.getInt(0) != 0;
-      position_.x = static_cast<float>(s.getDouble(1));
-      position_.z = static_cast<float>(s.getDouble(2));
-      rotation_ = static_cast<float>(s.getDouble(3));
-   }
-   else
-      throw std::runtime_error("Could not find feature to load follower data!");
-
-   calculateFarmingTransform();
 }
 
 // create one of a player's follower
-Follower::Follower(AssetManager& asset_mgr, Player& owner)
+Follower::Follower(Player& owner)
    : owner_(&owner),
-     mesh_(asset_mgr.getMesh("std-follower")),
-     color_(owner.getColor()),
      idle_(true),
      floating_(false),
      farming_(false),
      rotation_(0)
 {
-   calculateFarmingTransform();
-}
-
-void Follower::calculateFarmingTransform()
-{
-   farming_transform_ = glm::translate(glm::rotate(glm::translate(farming_transform_,
-      glm::vec3(0.0f, 0.1775f, 0.0f)),
-      -90.0f, glm::vec3(0.0f, 0.0f, 1.0f)),
-      glm::vec3(0.0f, -0.115f, 0.0f));
 }
 
 Player* Follower::getOwner()const
@@ -128,41 +88,6 @@ Player* Follower::getOwner()const
    return owner_;
 }
 
-void Follower::setColor(const glm::vec4& color)
-{
-   color_ = color;
-}
-
-void Follower::draw()const
-{
-   glPushMatrix();
-
-   glTranslatef(position_.x, position_.y, position_.z);
-   glRotatef(rotation_, 0, 1, 0);
-
-
-   if (owner_ == nullptr)
-   {
-      glScalef(0.5f, 0.5f, 0.5f);
-      glEnable(GL_NORMALIZE); // lighting is messed up when normals are scaled otherwise
-   }
-
-   if (farming_)
-      glMultMatrixf(glm::value_ptr(farming_transform_));
-   
-   
-
-   glColor4fv(glm::value_ptr(color_));
-
-   if (mesh_)
-      mesh_->draw(GL_MODULATE);
-
-   if (owner_ == nullptr)
-      glDisable(GL_NORMALIZE);
-
-   glPopMatrix();
-}
-
 bool Follower::isIdle()const
 {
    return idle_;
@@ -219,4 +144,14 @@ const glm::vec3& Follower::getPosition() const
    return position_;
 }
 
+bool Follower::isFarming() const
+{
+   return farming_;
+}
+
+float Follower::getRotation() const
+{
+   return rotation_;
+}
+
 }// namespace carcassonne
@@ -41,6 +41,7 @@ namespace carcassonne {
 Game::Game()
    : config_db_("carcassonne.ccconfig"),
      gfx_cfg_(gfx::GraphicsConfiguration::load(config_db_)),
+     ai_cfg_(ai::AiConfiguration::load(config_db_)),
      assets_(*this, "carcassonne.ccassets"),
      menu_camera_(gfx_cfg_)
 {
@@ -128,6 +129,11 @@ const gfx::GraphicsConfiguration& Game::getGraphicsConfiguration() const
    return gfx_cfg_;
 }
 
+const ai::AiConfiguration& Game::getAiConfiguration() const
+{
+   return ai_cfg_;
+}
+
 AssetManager& Game::getAssetManager()
 {
    return assets_;
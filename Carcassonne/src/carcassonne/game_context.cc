@@ -0,0 +1,96 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/game_context.cc
+//
+// Everything a single game owns that used to be shared between games: the
+// players sitting at the table and the PRNG that every other random choice
+// in the game is drawn from.
+
+#include "carcassonne/game_context.h"
+
+#include <algorithm>
+
+namespace carcassonne {
+
+GameContext::GameContext(unsigned int seed)
+   : seed_(seed),
+     prng_(static_cast<std::mt19937::result_type>(seed)),
+     results_recorded_(false)
+{
+}
+
+unsigned int GameContext::getSeed() const
+{
+   return seed_;
+}
+
+unsigned int GameContext::nextSeed()
+{
+   return static_cast<unsigned int>(prng_());
+}
+
+Player& GameContext::addPlayer(Player& profile)
+{
+   Player& player = addPlayer(profile.getName(), profile.isHuman(), profile.getSkillLevel(), profile.getColor());
+   profiles_.back() = &profile;
+   return player;
+}
+
+Player& GameContext::addPlayer(const std::string& name, bool human, Player::SkillLevel skill_level, const glm::vec4& color)
+{
+   seats_.push_back(std::unique_ptr<Player>(new Player(name, human)));
+   Player& player = *seats_.back();
+   player.setSkillLevel(skill_level);
+   player.newScenario(color);
+
+   players_.push_back(&player);
+   profiles_.push_back(nullptr);
+   return player;
+}
+
+const std::vector<Player*>& GameContext::getPlayers() const
+{
+   return players_;
+}
+
+void GameContext::recordResults()
+{
+   if (results_recorded_)
+      return;
+
+   results_recorded_ = true;
+
+   int high_score = 0;
+   for (auto i(players_.begin()), end(players_.end()); i != end; ++i)
+      high_score = std::max(high_score, (*i)->getScore());
+
+   for (size_t seat = 0; seat < players_.size(); ++seat)
+   {
+      if (profiles_[seat])
+      {
+         int score = players_[seat]->getScore();
+         profiles_[seat]->recordScenarioResult(score == high_score, score);
+      }
+   }
+}
+
+} // namespace carcassonne
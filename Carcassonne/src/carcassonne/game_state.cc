@@ -0,0 +1,428 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/game_state.cc
+//
+// The rules of a single match: the board, the draw pile, the players, and
+// the turn state machine which moves between tile placement, follower
+// placement, and scoring.
+
+#include "carcassonne/game_state.h"
+
+#include <cassert>
+
+#include "carcassonne/zobrist.h"
+
+namespace carcassonne {
+
+GameState::GameState(const std::vector<Player*>& players, Pile&& draw_pile, std::unique_ptr<Tile>&& starting_tile)
+   : game_over_(false),
+     draw_pile_(std::move(draw_pile)),
+     players_(players),
+     current_player_(players_.end()),
+     last_placed_tile_(nullptr),
+     current_follower_(nullptr)
+{
+   assert(players_.size() > 1);
+
+   board_.placeTileAt(glm::ivec2(0,0), std::move(starting_tile));
+   endTurn();
+}
+
+// The tiles which have already been drawn are stacked on top of the
+// remaining tiles in the reverse of the order they were drawn, so replaying
+// other's moves draws them again in the same order.  Discarded tiles are left
+// out; they're out of the game.
+GameState::GameState(const GameState& other, const std::vector<Player*>& players, unsigned int seed)
+   : game_over_(false),
+     draw_pile_(other.draw_pile_, seed),
+     players_(players),
+     current_player_(players_.end()),
+     last_placed_tile_(nullptr),
+     current_follower_(nullptr)
+{
+   assert(players_.size() == other.players_.size());
+   assert(other.last_placed_tile_ == nullptr);
+
+   for (size_t seat = 0; seat < players_.size(); ++seat)
+      players_[seat]->newScenario(other.players_[seat]->getColor());
+
+   if (other.current_tile_)
+      draw_pile_.add(other.current_tile_->getPrototype(), other.current_tile_->getRotation());
+
+   const std::vector<Tile*>& placed_tiles = other.board_.getPlacedTiles();
+   for (auto i(placed_tiles.rbegin()), end(placed_tiles.rend()); i != end; ++i)
+      draw_pile_.add((*i)->getPrototype(), (*i)->getRotation());
+
+   board_.placeTileAt(glm::ivec2(0,0), draw_pile_.remove());
+   endTurn();
+
+   for (auto i(other.turns_.begin()), end(other.turns_.end()); i != end; ++i)
+      apply(i->move);
+}
+
+Board& GameState::getBoard()
+{
+   return board_;
+}
+
+const Board& GameState::getBoard() const
+{
+   return board_;
+}
+
+const Pile& GameState::getDrawPile() const
+{
+   return draw_pile_;
+}
+
+const std::vector<Player*>& GameState::getPlayers() const
+{
+   return players_;
+}
+
+Player& GameState::getCurrentPlayer()
+{
+   return **current_player_;
+}
+
+const Player& GameState::getCurrentPlayer() const
+{
+   return **current_player_;
+}
+
+Tile* GameState::getCurrentTile() const
+{
+   return current_tile_.get();
+}
+
+Tile* GameState::getLastPlacedTile() const
+{
+   return last_placed_tile_;
+}
+
+Follower* GameState::getCurrentFollower() const
+{
+   return current_follower_;
+}
+
+const std::vector<features::Feature*>& GameState::getFollowerPlaceholders() const
+{
+   return follower_placeholders_;
+}
+
+bool GameState::isGameOver() const
+{
+   return game_over_;
+}
+
+int GameState::getFittingTileCount(const glm::ivec2& position) const
+{
+   unsigned char constraints = board_.getConstraints(position);
+   return constraints == 0 ? 0 : draw_pile_.getFittingCount(constraints);
+}
+
+// The board and draw pile hashes are updated incrementally as tiles are
+// placed and drawn.  There are only a few players and followers, and
+// followers can be returned by scoring deep inside the RegionStore, so their
+// keys (and the scores) are just combined here.
+unsigned long long GameState::getHash() const
+{
+   unsigned long long hash = board_.getHash() ^ draw_pile_.getHash();
+
+   if (current_tile_)
+      hash ^= zobrist::currentTile(current_tile_->getPrototype().index);
+
+   for (size_t seat = 0; seat < players_.size(); ++seat)
+   {
+      const Player& player = *players_[seat];
+      hash ^= zobrist::score(seat, player.getScore());
+
+      const std::vector<Follower>& followers = player.getFollowers();
+      for (auto i(followers.begin()), end(followers.end()); i != end; ++i)
+      {
+         if (i->isPlaced())
+            hash ^= zobrist::follower(seat, i->getPosition());
+      }
+   }
+
+   if (current_player_ != players_.end())
+      hash ^= zobrist::turn(current_player_ - players_.begin());
+
+   return hash;
+}
+
+void GameState::rotateTileClockwise()
+{
+   if (!current_tile_)
+      return;
+
+   current_tile_->rotateClockwise();
+   board_.tileRotated(*current_tile_);
+}
+
+void GameState::rotateTileCounterclockwise()
+{
+   if (!current_tile_)
+      return;
+
+   current_tile_->rotateCounterclockwise();
+   board_.tileRotated(*current_tile_);
+}
+
+const glm::ivec2* GameState::getNextPlaceableLocation()
+{
+   return board_.getNextPlaceableLocation();
+}
+
+size_t GameState::getMoves(Move* moves, size_t max_moves)
+{
+   if (!current_tile_ || game_over_)
+      return 0;
+
+   return board_.getMoves(*current_tile_, getCurrentPlayer(), moves, max_moves);
+}
+
+// switches to follower placement
+bool GameState::placeTile(const glm::ivec2& board_coords)
+{
+   if (!current_tile_)
+      return false;
+
+   Tile::Rotation rotation = current_tile_->getRotation();
+   last_placed_tile_ = current_tile_.get();
+   if (!board_.placeTileAt(board_coords, std::move(current_tile_)))
+   {
+      last_placed_tile_ = nullptr;
+      return false;
+   }
+   current_tile_.reset();
+
+   Follower* follower = getCurrentPlayer().getIdleFollower();
+
+   Turn turn;
+   turn.player = current_player_;
+   turn.move = Move(board_coords, rotation);
+   turn.rotation = rotation;
+   turn.follower = follower;
+   turn.discarded = 0;
+   turns_.push_back(turn);
+
+   if (follower != nullptr)
+   {
+      for (size_t i = 0; i < last_placed_tile_->getFeatureCount(); ++i)
+      {
+         features::Feature* feature = last_placed_tile_->getFeature(i);
+         if (feature->hasPlaceholder())
+            follower_placeholders_.push_back(feature);
+      }
+
+      if (!follower_placeholders_.empty())
+      {
+         current_follower_ = follower;
+         follower->setFloating(true);
+         return true;  // don't end turn
+      }
+   }
+
+   endTurn();
+   return true;
+}
+
+features::Feature* GameState::getNearestPlaceholder(const glm::vec3& world_coords, bool limit_distance) const
+{
+   if (!last_placed_tile_)
+      return nullptr;
+
+   glm::vec3 tile_coords(last_placed_tile_->worldToLocal(world_coords));
+
+   features::Feature* closest_feature(nullptr);
+   float closest_placeholder_distance(limit_distance ? 1.0f : -1.0f);
+   for (auto i(follower_placeholders_.begin()), end(follower_placeholders_.end()); i != end; ++i)
+   {
+      features::Feature* feature = *i;
+      const Follower* follower = feature->getPlaceholder();
+      float distance(glm::distance(tile_coords, follower->getPosition()));
+
+      if (closest_placeholder_distance < 0 || closest_placeholder_distance > distance)
+      {
+         closest_placeholder_distance = distance;
+         closest_feature = feature;
+      }
+   }
+
+   return closest_feature;
+}
+
+void GameState::placeFollower(features::Feature* feature)
+{
+   if (!current_follower_)
+      return;
+
+   if (feature)
+   {
+      turns_.back().move.follower = last_placed_tile_->getFeatureIndex(*feature);
+      feature->placeFollower(*current_follower_, *last_placed_tile_);
+   }
+   else
+      current_follower_->setIdle(true);
+
+   endTurn();
+}
+
+void GameState::endTurn()
+{
+   if (game_over_)
+      return;
+
+   if (last_placed_tile_)
+      last_placed_tile_->checkForCompleteFeatures();
+
+   // move current_player_ to the next player
+   if (current_player_ == players_.end())
+      current_player_ = players_.begin();
+   else
+   {
+      ++current_player_;
+      if (current_player_ == players_.end())
+         current_player_ = players_.begin();
+   }
+
+   // set current_tile_
+   current_tile_ = draw_pile_.remove();
+
+   while (current_tile_)
+   {
+      if (board_.usingNewTile(*current_tile_))
+         break;
+
+      // if the current tile isn't placeable anywhere, get a new tile and discard the old one
+      if (!turns_.empty())
+      {
+         discarded_.push_back(std::move(current_tile_));
+         ++turns_.back().discarded;
+      }
+      current_tile_ = draw_pile_.remove();
+   }
+
+   if (!current_tile_)
+   {
+      board_.scoreAllTiles();
+      game_over_ = true;
+   }
+
+   // set current_follower_
+   current_follower_ = nullptr;
+   last_placed_tile_ = nullptr;
+   follower_placeholders_.clear();
+}
+
+bool GameState::apply(const Move& move)
+{
+   if (!current_tile_ || game_over_)
+      return false;
+
+   if ((board_.getFittingRotations(move.position, *current_tile_) & (1 << move.rotation)) == 0)
+      return false;
+
+   Tile::Rotation rotation = current_tile_->getRotation();
+   while (current_tile_->getRotation() != move.rotation)
+      current_tile_->rotateClockwise();
+   board_.tileRotated(*current_tile_);
+
+   if (!placeTile(move.position))
+      return false;
+
+   // undo() should restore the rotation from before the move
+   turns_.back().rotation = rotation;
+
+   bool valid = true;
+   if (current_follower_)
+   {
+      features::Feature* feature = nullptr;
+      if (move.follower != Move::NO_FOLLOWER)
+      {
+         if (move.follower >= 0 && static_cast<size_t>(move.follower) < last_placed_tile_->getFeatureCount() &&
+             last_placed_tile_->getFeature(move.follower)->hasPlaceholder())
+            feature = last_placed_tile_->getFeature(move.follower);
+         else
+            valid = false;
+      }
+
+      placeFollower(feature);
+   }
+   else if (move.follower != Move::NO_FOLLOWER)
+      valid = false;
+
+   if (!valid)
+   {
+      undo();
+      return false;
+   }
+
+   return true;
+}
+
+// Tiles go back on the draw pile in the reverse of the order they were
+// drawn: the current tile, then any discarded tiles.  Undoing the placement
+// reverts the board and any scoring, including the final scoring at the end
+// of the game.
+bool GameState::undo()
+{
+   if (turns_.empty() || last_placed_tile_)
+      return false;
+
+   Turn turn = turns_.back();
+   turns_.pop_back();
+
+   game_over_ = false;
+
+   draw_pile_.putBack(std::move(current_tile_));
+   for (size_t i = 0; i < turn.discarded; ++i)
+   {
+      draw_pile_.putBack(std::move(discarded_.back()));
+      discarded_.pop_back();
+   }
+
+   current_tile_ = board_.undoPlacement();
+   while (current_tile_->getRotation() != turn.rotation)
+      current_tile_->rotateClockwise();
+
+   // if the follower was placed, undoing the placement left it floating
+   if (turn.follower && turn.follower->isFloating())
+      turn.follower->setIdle(true);
+
+   current_player_ = turn.player;
+   board_.usingNewTile(*current_tile_);
+   return true;
+}
+
+void GameState::shuffleDrawPile()
+{
+   draw_pile_.shuffle();
+}
+
+bool GameState::setNextTile(size_t prototype)
+{
+   return draw_pile_.moveToTop(prototype);
+}
+
+} // namespace carcassonne
@@ -0,0 +1,241 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/batch.cc
+//
+// Many instances of meshes baked into one vertex buffer.
+
+#include "carcassonne/gfx/batch.h"
+
+#include <algorithm>
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include "carcassonne/gfx/gl_functions.h"
+
+namespace carcassonne {
+namespace gfx {
+
+Batch::Batch(const GraphicsConfiguration& gfx_cfg)
+   : gfx_cfg_(gfx_cfg),
+     instances_(0),
+     vertex_buffer_id_(0),
+     index_buffer_id_(0),
+     vertex_capacity_(0),
+     index_capacity_(0),
+     uploaded_vertices_(0),
+     uploaded_indices_(0)
+{
+}
+
+Batch::~Batch()
+{
+   if (vertex_buffer_id_ != 0)
+      gl::deleteBuffers(1, &vertex_buffer_id_);
+
+   if (index_buffer_id_ != 0)
+      gl::deleteBuffers(1, &index_buffer_id_);
+}
+
+// The buffers are kept, so the batch can be refilled without reallocating
+// them.
+void Batch::clear()
+{
+   vertices_.clear();
+   indices_.clear();
+   instances_ = 0;
+   uploaded_vertices_ = 0;
+   uploaded_indices_ = 0;
+}
+
+// The vertices are transformed here, once, rather than by the modelview
+// matrix every frame.  Normals are renormalized, so instances can be scaled
+// without enabling GL_NORMALIZE.
+void Batch::add(const Mesh& mesh, const glm::mat4& transform, const glm::vec4& color)
+{
+   add(mesh, transform, color, glm::vec4(0, 0, 1, 1));
+}
+
+// Meshes may use texture coordinates outside [0, 1] (relying on GL_REPEAT),
+// so they're first shifted so the smallest is in [0, 1).  A mesh which
+// repeats its texture more than once can't be drawn from an atlas.
+void Batch::add(const Mesh& mesh, const glm::mat4& transform, const glm::vec4& color, const glm::vec4& texture_rect)
+{
+   const std::vector<Mesh::Vertex>& vertices = mesh.getVertices();
+   const std::vector<GLuint>& triangles = mesh.getTriangles();
+   if (triangles.empty())
+      return;
+
+   glm::mat3 normal_transform(glm::inverseTranspose(glm::mat3(transform)));
+   GLuint base = static_cast<GLuint>(vertices_.size());
+
+   glm::vec2 texture_origin(vertices.front().texture_coord);
+   for (auto i(vertices.begin()), end(vertices.end()); i != end; ++i)
+      texture_origin = glm::min(texture_origin, glm::vec2(i->texture_coord));
+   texture_origin = glm::floor(texture_origin);
+
+   glm::vec2 texture_offset(texture_rect.x, texture_rect.y);
+   glm::vec2 texture_scale(texture_rect.z, texture_rect.w);
+   bool whole_texture = texture_rect == glm::vec4(0, 0, 1, 1);
+
+   for (auto i(vertices.begin()), end(vertices.end()); i != end; ++i)
+   {
+      Vertex v;
+      v.texture_coord = i->texture_coord;
+      if (!whole_texture)
+      {
+         glm::vec2 st(texture_offset + (glm::vec2(v.texture_coord) - texture_origin) * texture_scale);
+         v.texture_coord = glm::vec3(st, v.texture_coord.z);
+      }
+      v.color = color;
+      v.normal = glm::normalize(normal_transform * i->normal);
+      v.position = glm::vec3(transform * glm::vec4(i->position, 1.0f));
+      vertices_.push_back(v);
+
+      if (vertices_.size() == 1)
+         min_ = max_ = v.position;
+      else
+      {
+         min_ = glm::min(min_, v.position);
+         max_ = glm::max(max_, v.position);
+      }
+   }
+
+   for (auto i(triangles.begin()), end(triangles.end()); i != end; ++i)
+      indices_.push_back(base + *i);
+
+   ++instances_;
+}
+
+size_t Batch::getInstanceCount() const
+{
+   return instances_;
+}
+
+const glm::vec3& Batch::getMin() const
+{
+   return min_;
+}
+
+const glm::vec3& Batch::getMax() const
+{
+   return max_;
+}
+
+void Batch::draw() const
+{
+   if (indices_.empty())
+      return;
+
+   const GLsizei stride = sizeof(Vertex);
+   const char* vertex_data = nullptr;
+   const GLuint* index_data = nullptr;
+
+   bool buffers = useBuffers();
+   if (buffers)
+   {
+      upload();
+      gl::bindBuffer(GL_ARRAY_BUFFER, vertex_buffer_id_);
+      gl::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_id_);
+   }
+   else
+   {
+      vertex_data = reinterpret_cast<const char*>(&vertices_[0]);
+      index_data = &indices_[0];
+   }
+
+   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+   glEnableClientState(GL_COLOR_ARRAY);
+   glEnableClientState(GL_NORMAL_ARRAY);
+   glEnableClientState(GL_VERTEX_ARRAY);
+
+   glTexCoordPointer(3, GL_FLOAT, stride, vertex_data + offsetof(Vertex, texture_coord));
+   glColorPointer(4, GL_FLOAT, stride, vertex_data + offsetof(Vertex, color));
+   glNormalPointer(GL_FLOAT, stride, vertex_data + offsetof(Vertex, normal));
+   glVertexPointer(3, GL_FLOAT, stride, vertex_data + offsetof(Vertex, position));
+
+   glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices_.size()), GL_UNSIGNED_INT, index_data);
+
+   glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+   glDisableClientState(GL_COLOR_ARRAY);
+   glDisableClientState(GL_NORMAL_ARRAY);
+   glDisableClientState(GL_VERTEX_ARRAY);
+
+   if (buffers)
+   {
+      gl::bindBuffer(GL_ARRAY_BUFFER, 0);
+      gl::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+   }
+}
+
+// Without buffer objects (before OpenGL 1.5) the batch is drawn from client
+// memory instead.
+bool Batch::useBuffers() const
+{
+   if (vertex_buffer_id_ != 0)
+      return true;
+
+   if (!gl::isVersionAtLeast(gfx_cfg_.gl_version_major, gfx_cfg_.gl_version_minor, 1, 5))
+      return false;
+
+   if (!gl::genBuffers && !gl::loadBufferObjects())
+      return false;
+
+   gl::genBuffers(1, &vertex_buffer_id_);
+   gl::genBuffers(1, &index_buffer_id_);
+   return true;
+}
+
+// Only the instances added since the last upload are copied, unless the
+// buffers have to grow.  They grow geometrically, so a game's worth of tiles
+// only reallocates them a few times.
+void Batch::upload() const
+{
+   gl::bindBuffer(GL_ARRAY_BUFFER, vertex_buffer_id_);
+   if (vertices_.size() > vertex_capacity_)
+   {
+      vertex_capacity_ = std::max(vertices_.size(), vertex_capacity_ * 2);
+      gl::bufferData(GL_ARRAY_BUFFER, vertex_capacity_ * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+      uploaded_vertices_ = 0;
+   }
+   if (uploaded_vertices_ < vertices_.size())
+   {
+      gl::bufferSubData(GL_ARRAY_BUFFER, uploaded_vertices_ * sizeof(Vertex),
+                        (vertices_.size() - uploaded_vertices_) * sizeof(Vertex), &vertices_[uploaded_vertices_]);
+      uploaded_vertices_ = vertices_.size();
+   }
+
+   gl::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_id_);
+   if (indices_.size() > index_capacity_)
+   {
+      index_capacity_ = std::max(indices_.size(), index_capacity_ * 2);
+      gl::bufferData(GL_ELEMENT_ARRAY_BUFFER, index_capacity_ * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+      uploaded_indices_ = 0;
+   }
+   if (uploaded_indices_ < indices_.size())
+   {
+      gl::bufferSubData(GL_ELEMENT_ARRAY_BUFFER, uploaded_indices_ * sizeof(GLuint),
+                        (indices_.size() - uploaded_indices_) * sizeof(GLuint), &indices_[uploaded_indices_]);
+      uploaded_indices_ = indices_.size();
+   }
+}
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
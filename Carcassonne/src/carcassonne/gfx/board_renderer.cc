@@ -0,0 +1,442 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/board_renderer.cc
+//
+// Draws the objects from the rules core (tiles, followers, and follower
+// placeholders) using meshes and textures from the AssetManager.
+
+#include "carcassonne/gfx/board_renderer.h"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "carcassonne/asset_manager.h"
+
+namespace carcassonne {
+namespace gfx {
+
+BoardRenderer::BoardRenderer(AssetManager& asset_mgr)
+   : asset_mgr_(asset_mgr),
+     tile_mesh_(asset_mgr.getMesh("std-tile")),
+     follower_mesh_(asset_mgr.getMesh("std-follower")),
+     tile_atlas_(nullptr),
+     placeholder_batch_(asset_mgr.getGraphicsConfiguration())
+{
+   farming_transform_ = glm::translate(glm::rotate(glm::translate(farming_transform_,
+      glm::vec3(0.0f, 0.1775f, 0.0f)),
+      -90.0f, glm::vec3(0.0f, 0.0f, 1.0f)),
+      glm::vec3(0.0f, -0.115f, 0.0f));
+
+   // Tiles can be rotated, so the x & z extents are the same.
+   if (tile_mesh_)
+   {
+      const std::vector<Mesh::Vertex>& vertices = tile_mesh_->getVertices();
+      for (auto i(vertices.begin()), end(vertices.end()); i != end; ++i)
+      {
+         float xz = std::max(std::abs(i->position.x), std::abs(i->position.z));
+         tile_extents_ = glm::max(tile_extents_, glm::vec3(xz, std::abs(i->position.y), xz));
+      }
+   }
+}
+
+BoardRenderer::Stats::Stats()
+   : chunks_drawn(0),
+     chunks_culled(0),
+     tiles_drawn(0),
+     tiles_culled(0),
+     followers_drawn(0),
+     followers_culled(0),
+     empty_tiles_drawn(0),
+     empty_tiles_culled(0)
+{
+}
+
+BoardRenderer::Chunk::Chunk(const GraphicsConfiguration& gfx_cfg)
+   : followers(gfx_cfg),
+     dirty(false)
+{
+}
+
+// Tiles are only ever added to the board during a game, so normally the new
+// ones are just appended to their chunks' batches.  If the board doesn't
+// start with the tiles that were batched (e.g. a turn was undone), the tiles
+// after the first difference are taken out of their chunks, and only those
+// chunks are rebuilt.
+void BoardRenderer::update(const GameState& state)
+{
+   const std::vector<Tile*>& tiles = state.getBoard().getPlacedTiles();
+
+   // With an atlas of the tileset's textures, each chunk's tiles go in one
+   // batch.
+   const std::shared_ptr<const Tileset>& tileset = state.getDrawPile().getTileset();
+   tile_atlas_ = tileset ? asset_mgr_.getTileAtlas(*tileset) : nullptr;
+
+   size_t unchanged = 0;
+   while (unchanged < batched_tiles_.size() && unchanged < tiles.size())
+   {
+      const BatchedTile& batched = batched_tiles_[unchanged];
+      const Tile& tile = *tiles[unchanged];
+      if (batched.tile != &tile || batched.position != tile.getPosition() || batched.rotation != tile.getRotation())
+         break;
+
+      ++unchanged;
+   }
+
+   while (batched_tiles_.size() > unchanged)
+   {
+      Chunk& chunk = getChunk(batched_tiles_.back().position);
+      chunk.placed_tiles.pop_back();
+      chunk.dirty = true;
+      batched_tiles_.pop_back();
+   }
+
+   for (auto i(tiles.begin() + unchanged), end(tiles.end()); i != end; ++i)
+   {
+      const Tile& tile = **i;
+
+      Chunk& chunk = getChunk(tile.getPosition());
+      chunk.placed_tiles.push_back(&tile);
+      if (!chunk.dirty)
+         addTile(chunk, tile);
+
+      BatchedTile batched;
+      batched.tile = &tile;
+      batched.position = tile.getPosition();
+      batched.rotation = tile.getRotation();
+      batched_tiles_.push_back(batched);
+   }
+
+   for (auto c(chunks_.begin()), cend(chunks_.end()); c != cend; ++c)
+   {
+      Chunk& chunk = *c->second;
+      if (!chunk.dirty)
+         continue;
+
+      for (auto i(chunk.tiles.begin()), end(chunk.tiles.end()); i != end; ++i)
+         i->second->clear();
+
+      for (auto i(chunk.placed_tiles.begin()), end(chunk.placed_tiles.end()); i != end; ++i)
+         addTile(chunk, **i);
+
+      chunk.dirty = false;
+   }
+
+   for (auto c(chunks_.begin()), cend(chunks_.end()); c != cend; ++c)
+      c->second->followers.clear();
+
+   placeholder_batch_.clear();
+   if (!follower_mesh_)
+      return;
+
+   const std::vector<Player*>& players = state.getPlayers();
+   for (auto p(players.begin()), pend(players.end()); p != pend; ++p)
+   {
+      const std::vector<Follower>& followers = (*p)->getFollowers();
+      for (auto i(followers.begin()), end(followers.end()); i != end; ++i)
+      {
+         if (i->isPlaced())
+            getChunk(i->getPosition()).followers.add(*follower_mesh_, getFollowerTransform(*i), (*p)->getColor());
+      }
+   }
+
+   if (state.getCurrentFollower())
+   {
+      glm::mat4 tile_transform(getTileTransform(*state.getLastPlacedTile()));
+      const glm::vec4& color = state.getCurrentPlayer().getColor();
+
+      const std::vector<features::Feature*>& features = state.getFollowerPlaceholders();
+      for (auto i(features.begin()), end(features.end()); i != end; ++i)
+      {
+         const Follower* placeholder = (*i)->getPlaceholder();
+         if (placeholder)
+            placeholder_batch_.add(*follower_mesh_, tile_transform * getFollowerTransform(*placeholder), color);
+      }
+   }
+}
+
+void BoardRenderer::drawBoard(const Frustum& frustum) const
+{
+   stats_ = Stats();
+
+   for (auto c(chunks_.begin()), cend(chunks_.end()); c != cend; ++c)
+   {
+      bool drawn = false;
+      bool culled = false;
+
+      const BatchMap& batches = c->second->tiles;
+      for (auto i(batches.begin()), end(batches.end()); i != end; ++i)
+      {
+         const Batch& batch = *i->second;
+         if (batch.getInstanceCount() == 0)
+            continue;
+
+         if (!frustum.intersects(batch.getMin(), batch.getMax()))
+         {
+            stats_.tiles_culled += batch.getInstanceCount();
+            culled = true;
+            continue;
+         }
+
+         if (i->first)
+            i->first->enable(GL_MODULATE);
+         else
+            Texture::disableAny();
+
+         batch.draw();
+         stats_.tiles_drawn += batch.getInstanceCount();
+         drawn = true;
+      }
+
+      if (drawn)
+         ++stats_.chunks_drawn;
+      else if (culled)
+         ++stats_.chunks_culled;
+   }
+}
+
+void BoardRenderer::drawEmptyTiles(const Board& board, const Frustum& frustum) const
+{
+   Texture::disableAny();
+   glDepthMask(false);
+
+   const std::vector<glm::ivec2>& locations = board.getEmptyLocations();
+   for (auto i(locations.begin()), end(locations.end()); i != end; ++i)
+   {
+      glm::vec3 position(float(i->x), 0.0f, float(i->y));
+      if (!frustum.intersects(position - tile_extents_, position + tile_extents_))
+      {
+         ++stats_.empty_tiles_culled;
+         continue;
+      }
+      ++stats_.empty_tiles_drawn;
+
+      glm::vec4 color;
+      switch (board.getEmptyType(*i))
+      {
+         case Tile::TYPE_EMPTY_PLACEABLE:            color = glm::vec4(0.4, 1, 0.4, 0.2); break;
+         case Tile::TYPE_EMPTY_PLACEABLE_IF_ROTATED: color = glm::vec4(1, 1, 0.4, 0.2); break;
+         default:                                    color = glm::vec4(1, 0.4, 0.4, 0.2); break;
+      }
+
+      glPushMatrix();
+      glTranslatef(float(i->x), 0.0f, float(i->y));
+      glColor4fv(glm::value_ptr(color));
+
+      if (tile_mesh_)
+         tile_mesh_->drawBase();
+
+      glPopMatrix();
+   }
+
+   glDepthMask(true);
+}
+
+void BoardRenderer::drawTile(const Tile& tile) const
+{
+   const glm::vec3& position = tile.getPosition();
+
+   glPushMatrix();
+   glTranslatef(position.x, position.y, position.z);
+
+   float angle = -90.0f * static_cast<int>(tile.getRotation());
+   glRotatef(angle, 0, 1, 0);
+
+   glColor4f(1, 1, 1, 1);
+
+   Texture* texture = getTexture(tile.getTextureName());
+   if (texture)
+      texture->enable(GL_MODULATE);
+   else
+      Texture::disableAny();
+
+   if (tile_mesh_)
+      tile_mesh_->drawBase();
+
+   glPopMatrix();
+}
+
+void BoardRenderer::drawPlaceholders() const
+{
+   drawFollowerBatch(placeholder_batch_);
+}
+
+void BoardRenderer::drawFollower(const Follower& follower) const
+{
+   Player* owner = follower.getOwner();
+   drawFollower(follower, owner ? owner->getColor() : glm::vec4(1, 1, 1, 1));
+}
+
+void BoardRenderer::drawPlacedFollowers(const Frustum& frustum) const
+{
+   for (auto c(chunks_.begin()), cend(chunks_.end()); c != cend; ++c)
+   {
+      const Batch& batch = c->second->followers;
+      if (batch.getInstanceCount() == 0)
+         continue;
+
+      if (frustum.intersects(batch.getMin(), batch.getMax()))
+      {
+         drawFollowerBatch(batch);
+         stats_.followers_drawn += batch.getInstanceCount();
+      }
+      else
+         stats_.followers_culled += batch.getInstanceCount();
+   }
+}
+
+void BoardRenderer::drawIdleFollowers(const Player& player) const
+{
+   glPushMatrix();
+   glTranslatef(0.0f, 0.95f, 0.0f);
+   glScalef(0.15f, -0.15f, 0.15f);
+
+   const std::vector<Follower>& followers = player.getFollowers();
+   for (auto i(followers.begin()), end(followers.end()); i != end; ++i)
+      if (i->isIdle() && !i->isFloating())
+         drawFollower(*i, player.getColor());
+
+   glPopMatrix();
+}
+
+void BoardRenderer::drawFollower(const Follower& follower, const glm::vec4& color) const
+{
+   const glm::vec3& position = follower.getPosition();
+   bool placeholder = follower.getOwner() == nullptr;
+
+   glPushMatrix();
+
+   glTranslatef(position.x, position.y, position.z);
+   glRotatef(follower.getRotation(), 0, 1, 0);
+
+   if (placeholder)
+   {
+      glScalef(0.5f, 0.5f, 0.5f);
+      glEnable(GL_NORMALIZE); // lighting is messed up when normals are scaled otherwise
+   }
+
+   if (follower.isFarming())
+      glMultMatrixf(glm::value_ptr(farming_transform_));
+
+   glColor4fv(glm::value_ptr(color));
+
+   if (follower_mesh_)
+      follower_mesh_->draw(GL_MODULATE);
+
+   if (placeholder)
+      glDisable(GL_NORMALIZE);
+
+   glPopMatrix();
+}
+
+void BoardRenderer::drawFollowerBatch(const Batch& batch) const
+{
+   if (batch.getInstanceCount() == 0)
+      return;
+
+   const Texture* texture = follower_mesh_->getTexture();
+   if (texture)
+      texture->enable(GL_MODULATE);
+   else
+      Texture::disableAny();
+
+   batch.draw();
+}
+
+void BoardRenderer::addTile(Chunk& chunk, const Tile& tile)
+{
+   if (!tile_mesh_)
+      return;
+
+   size_t layer = tile.getPrototype().index;
+   bool use_atlas = tile_atlas_ && layer < tile_atlas_->getLayerCount();
+
+   const Texture* texture = use_atlas ? &tile_atlas_->getTexture() : getTexture(tile.getTextureName());
+   std::unique_ptr<Batch>& batch = chunk.tiles[texture];
+   if (!batch)
+      batch.reset(new Batch(asset_mgr_.getGraphicsConfiguration()));
+
+   if (use_atlas)
+      batch->add(*tile_mesh_, getTileTransform(tile), glm::vec4(1, 1, 1, 1), tile_atlas_->getLayerRect(layer));
+   else
+      batch->add(*tile_mesh_, getTileTransform(tile), glm::vec4(1, 1, 1, 1));
+}
+
+const BoardRenderer::Stats& BoardRenderer::getStats() const
+{
+   return stats_;
+}
+
+// Tile positions are the centers of tiles, so a chunk's tiles are the ones
+// whose centers are within half a tile of its square.
+BoardRenderer::Chunk& BoardRenderer::getChunk(const glm::vec3& position)
+{
+   std::pair<int, int> key(static_cast<int>(std::floor((position.x + 0.5f) / CHUNK_SIZE)),
+                           static_cast<int>(std::floor((position.z + 0.5f) / CHUNK_SIZE)));
+
+   std::unique_ptr<Chunk>& chunk = chunks_[key];
+   if (!chunk)
+      chunk.reset(new Chunk(asset_mgr_.getGraphicsConfiguration()));
+
+   return *chunk;
+}
+
+glm::mat4 BoardRenderer::getTileTransform(const Tile& tile) const
+{
+   float angle = -90.0f * static_cast<int>(tile.getRotation());
+   return glm::rotate(glm::translate(glm::mat4(), tile.getPosition()), angle, glm::vec3(0, 1, 0));
+}
+
+// Placeholders (followers without an owner) are drawn at half size, relative
+// to their tile.
+glm::mat4 BoardRenderer::getFollowerTransform(const Follower& follower) const
+{
+   glm::mat4 transform(glm::rotate(glm::translate(glm::mat4(), follower.getPosition()),
+                                   follower.getRotation(), glm::vec3(0, 1, 0)));
+
+   if (follower.getOwner() == nullptr)
+      transform = glm::scale(transform, glm::vec3(0.5f, 0.5f, 0.5f));
+
+   if (follower.isFarming())
+      transform *= farming_transform_;
+
+   return transform;
+}
+
+// Tiles only know the name of their texture; look up (and remember) the
+// actual texture so that failed loads aren't retried every frame.
+Texture* BoardRenderer::getTexture(const std::string& name) const
+{
+   if (name.empty())
+      return nullptr;
+
+   auto i(textures_.find(name));
+   if (i != textures_.end())
+      return i->second;
+
+   Texture* texture = asset_mgr_.getTexture(name);
+   textures_[name] = texture;
+   return texture;
+}
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
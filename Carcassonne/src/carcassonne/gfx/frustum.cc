@@ -0,0 +1,67 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/frustum.cc
+//
+// The six clipping planes of a camera's view volume, in world space.
+
+#include "carcassonne/gfx/frustum.h"
+
+namespace carcassonne {
+namespace gfx {
+
+// A point p is inside the view volume if -w <= x, y, z <= w, where
+// (x, y, z, w) = view_projection * p.  Each of those inequalities is a plane
+// made of the sum or difference of two rows of the matrix (Gribb & Hartmann).
+Frustum::Frustum(const glm::mat4& view_projection)
+{
+   glm::vec4 rows[4];
+   for (int i = 0; i < 4; ++i)
+      rows[i] = glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+
+   planes_[0] = rows[3] + rows[0];  // left
+   planes_[1] = rows[3] - rows[0];  // right
+   planes_[2] = rows[3] + rows[1];  // bottom
+   planes_[3] = rows[3] - rows[1];  // top
+   planes_[4] = rows[3] + rows[2];  // near
+   planes_[5] = rows[3] - rows[2];  // far
+}
+
+// Only the corner of the box furthest along each plane's normal needs to be
+// tested; if it's behind the plane, the whole box is.
+bool Frustum::intersects(const glm::vec3& min, const glm::vec3& max) const
+{
+   for (int i = 0; i < 6; ++i)
+   {
+      const glm::vec4& plane = planes_[i];
+      glm::vec3 corner(plane.x >= 0 ? max.x : min.x,
+                       plane.y >= 0 ? max.y : min.y,
+                       plane.z >= 0 ? max.z : min.z);
+
+      if (glm::dot(glm::vec3(plane), corner) + plane.w < 0)
+         return false;
+   }
+
+   return true;
+}
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
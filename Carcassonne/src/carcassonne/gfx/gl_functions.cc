@@ -0,0 +1,117 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/gl_functions.cc
+//
+// OpenGL entry points newer than OpenGL 1.1, loaded at runtime.
+
+#include "carcassonne/gfx/gl_functions.h"
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+#include <GL/glx.h>
+#endif
+
+namespace carcassonne {
+namespace gfx {
+namespace gl {
+
+namespace {
+
+// Returns the address of an OpenGL function, or nullptr if the driver
+// doesn't provide it.  On Windows, the address is only valid for contexts
+// with the same pixel format as the current one, so functions should be
+// reloaded whenever the window is recreated.
+void* getProcAddress(const char* name)
+{
+#if defined(_WIN32)
+   void* address = reinterpret_cast<void*>(wglGetProcAddress(name));
+
+   // some drivers return small integers instead of nullptr on failure
+   std::ptrdiff_t value = reinterpret_cast<std::ptrdiff_t>(address);
+   if (value >= -1 && value <= 3)
+      return nullptr;
+
+   return address;
+#elif defined(__APPLE__)
+   return nullptr;
+#else
+   return reinterpret_cast<void*>(glXGetProcAddressARB(reinterpret_cast<const GLubyte*>(name)));
+#endif
+}
+
+template <typename T>
+bool load(T& function, const char* name)
+{
+   function = reinterpret_cast<T>(getProcAddress(name));
+   return function != nullptr;
+}
+
+} // namespace
+
+GenBuffersProc genBuffers = nullptr;
+DeleteBuffersProc deleteBuffers = nullptr;
+BindBufferProc bindBuffer = nullptr;
+BufferDataProc bufferData = nullptr;
+BufferSubDataProc bufferSubData = nullptr;
+
+GenVertexArraysProc genVertexArrays = nullptr;
+DeleteVertexArraysProc deleteVertexArrays = nullptr;
+BindVertexArrayProc bindVertexArray = nullptr;
+
+bool loadBufferObjects()
+{
+   if (load(genBuffers, "glGenBuffers") &&
+       load(deleteBuffers, "glDeleteBuffers") &&
+       load(bindBuffer, "glBindBuffer") &&
+       load(bufferData, "glBufferData") &&
+       load(bufferSubData, "glBufferSubData"))
+      return true;
+
+   genBuffers = nullptr;
+   deleteBuffers = nullptr;
+   bindBuffer = nullptr;
+   bufferData = nullptr;
+   bufferSubData = nullptr;
+   return false;
+}
+
+bool loadVertexArrays()
+{
+   if (load(genVertexArrays, "glGenVertexArrays") &&
+       load(deleteVertexArrays, "glDeleteVertexArrays") &&
+       load(bindVertexArray, "glBindVertexArray"))
+      return true;
+
+   genVertexArrays = nullptr;
+   deleteVertexArrays = nullptr;
+   bindVertexArray = nullptr;
+   return false;
+}
+
+bool isVersionAtLeast(unsigned int version_major, unsigned int version_minor,
+                      unsigned int major, unsigned int minor)
+{
+   return version_major > major || (version_major == major && version_minor >= minor);
+}
+
+} // namespace carcassonne::gfx::gl
+} // namespace carcassonne::gfx
+} // namespace carcassonne
@@ -26,17 +26,38 @@
 
 #include "carcassonne/gfx/mesh.h"
 
+#include <map>
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "carcassonne/asset_manager.h"
 #include "carcassonne/db/stmt.h"
+#include "carcassonne/gfx/gl_functions.h"
 
 namespace carcassonne {
 namespace gfx {
 
+namespace {
+
+struct IndexLess
+{
+   bool operator()(const glm::ivec3& a, const glm::ivec3& b) const
+   {
+      if (a.x != b.x) return a.x < b.x;
+      if (a.y != b.y) return a.y < b.y;
+      return a.z < b.z;
+   }
+};
+
+} // namespace
 
 Mesh::Mesh(AssetManager& asset_mgr, const std::string& name)
-   : display_list_id_(0)
+   : name_(name),
+     gfx_cfg_(asset_mgr.getGraphicsConfiguration()),
+     display_list_id_(0),
+     vertex_buffer_id_(0),
+     index_buffer_id_(0),
+     vertex_array_id_(0)
 {
    db::DB& db(asset_mgr.getDB());
 
@@ -110,23 +131,73 @@ Mesh::Mesh(AssetManager& asset_mgr, const std::string& name)
          }
       }
    }
+
+   buildBuffers();
+   buildTriangles();
+   init();
 }
 
-void Mesh::init()
+Mesh::~Mesh()
 {
-   if (display_list_id_ != 0)
-   {
-      glDeleteLists(display_list_id_, 1);
-      display_list_id_ = 0;
-   }
+   destroy();
 }
 
-Mesh::~Mesh()
+// Deletes any OpenGL objects belonging to the mesh, then uploads it again,
+// so nothing needs to be compiled on the first draw.  Called after the
+// context is recreated.
+void Mesh::init()
 {
-   if (display_list_id_ != 0)
+   // Unlike buffers and display lists, vertex array objects aren't shared
+   // between contexts, so the old VAO died with the old context.  Deleting
+   // its name now could delete a VAO another mesh has already generated in
+   // the new context.
+   vertex_array_id_ = 0;
+   destroy();
+
+   if (gl::isVersionAtLeast(gfx_cfg_.gl_version_major, gfx_cfg_.gl_version_minor, 1, 5) &&
+       gl::loadBufferObjects())
    {
-      glDeleteLists(display_list_id_, 1);
-      display_list_id_ = 0;
+      gl::genBuffers(1, &vertex_buffer_id_);
+      gl::bindBuffer(GL_ARRAY_BUFFER, vertex_buffer_id_);
+      gl::bufferData(GL_ARRAY_BUFFER, buffer_vertices_.size() * sizeof(Vertex),
+                     buffer_vertices_.empty() ? nullptr : &buffer_vertices_[0], GL_STATIC_DRAW);
+      gl::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+      gl::genBuffers(1, &index_buffer_id_);
+      gl::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_id_);
+      gl::bufferData(GL_ELEMENT_ARRAY_BUFFER, buffer_indices_.size() * sizeof(GLuint),
+                     buffer_indices_.empty() ? nullptr : &buffer_indices_[0], GL_STATIC_DRAW);
+      gl::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+      // A vertex array object remembers the buffer bindings and pointers, so
+      // drawing only needs one bind.  It belongs to this context only.
+      if (gl::isVersionAtLeast(gfx_cfg_.gl_version_major, gfx_cfg_.gl_version_minor, 3, 0) &&
+          gl::loadVertexArrays())
+      {
+         gl::genVertexArrays(1, &vertex_array_id_);
+         gl::bindVertexArray(vertex_array_id_);
+         bindBuffers();
+         gl::bindVertexArray(0);
+         gl::bindBuffer(GL_ARRAY_BUFFER, 0);
+      }
+   }
+   else
+   {
+      display_list_id_ = glGenLists(1);
+      glNewList(display_list_id_, GL_COMPILE);
+
+      glBegin(primitive_type_);
+
+      for (auto i(indices_.begin()), end(indices_.end()); i != end; ++i)
+      {
+         glTexCoord3fv(glm::value_ptr(texture_coords_[i->z]));
+         glNormal3fv(glm::value_ptr(normals_[i->y]));
+         glVertex3fv(glm::value_ptr(vertices_[i->x]));
+      }
+
+      glEnd();
+
+      glEndList();
    }
 }
 
@@ -134,6 +205,22 @@ const std::string& Mesh::getName() const
 {
    return name_;
 }
+
+const Texture* Mesh::getTexture() const
+{
+   return texture_;
+}
+
+const std::vector<Mesh::Vertex>& Mesh::getVertices() const
+{
+   return buffer_vertices_;
+}
+
+const std::vector<GLuint>& Mesh::getTriangles() const
+{
+   return triangles_;
+}
+
 // Uses texture specified by this mesh
 // make sure depth buffer writing and GL_DEPTH_TEST are enabled before drawing!
 void Mesh::draw() const
@@ -173,25 +260,153 @@ void Mesh::drawBase() const
 {
    if (display_list_id_ != 0)
       glCallList(display_list_id_);
-   else
+   else if (vertex_array_id_ != 0)
    {
-      display_list_id_ = glGenLists(1);
-      glNewList(display_list_id_, GL_COMPILE_AND_EXECUTE);
-   
-      glBegin(primitive_type_);
+      gl::bindVertexArray(vertex_array_id_);
+      glDrawElements(primitive_type_, static_cast<GLsizei>(buffer_indices_.size()), GL_UNSIGNED_INT, nullptr);
+      gl::bindVertexArray(0);
+   }
+   else if (vertex_buffer_id_ != 0)
+   {
+      bindBuffers();
+      glDrawElements(primitive_type_, static_cast<GLsizei>(buffer_indices_.size()), GL_UNSIGNED_INT, nullptr);
+      unbindBuffers();
+   }
+}
 
-      for (auto i(indices_.begin()), end(indices_.end()); i != end; ++i)
+// Each distinct (vertex, normal, texture coordinate) index triple in indices_
+// becomes one interleaved Vertex, since buffer objects can only be indexed
+// by a single index per vertex.
+void Mesh::buildBuffers()
+{
+   std::map<glm::ivec3, GLuint, IndexLess> vertex_ids;
+
+   buffer_indices_.reserve(indices_.size());
+   for (auto i(indices_.begin()), end(indices_.end()); i != end; ++i)
+   {
+      auto result(vertex_ids.insert(std::make_pair(*i, static_cast<GLuint>(buffer_vertices_.size()))));
+      if (result.second)
       {
-         glTexCoord3fv(glm::value_ptr(texture_coords_[i->z]));
-         glNormal3fv(glm::value_ptr(normals_[i->y]));
-         glVertex3fv(glm::value_ptr(vertices_[i->x]));
+         Vertex v;
+         v.texture_coord = texture_coords_[i->z];
+         v.normal = normals_[i->y];
+         v.position = vertices_[i->x];
+         buffer_vertices_.push_back(v);
       }
 
-      glEnd();
+      buffer_indices_.push_back(result.first->second);
+   }
+}
 
-      glEndList();
+// Batches draw many meshes with one call, so they can only use primitives
+// which can be concatenated.  Strips, fans, quads, and polygons are split into
+// triangles with the same winding.
+void Mesh::buildTriangles()
+{
+   const std::vector<GLuint>& v = buffer_indices_;
+   size_t n = v.size();
+
+   switch (primitive_type_)
+   {
+      case GL_TRIANGLES:
+         triangles_.assign(v.begin(), v.begin() + n - n % 3);
+         break;
+
+      case GL_QUADS:
+         for (size_t i = 3; i < n; i += 4)
+         {
+            GLuint t[] = { v[i - 3], v[i - 2], v[i - 1], v[i - 3], v[i - 1], v[i] };
+            triangles_.insert(triangles_.end(), t, t + 6);
+         }
+         break;
+
+      case GL_TRIANGLE_STRIP:
+         for (size_t i = 2; i < n; ++i)
+         {
+            GLuint t[] = { v[i - 2], v[i - 1], v[i] };
+            if (i % 2 != 0)
+               std::swap(t[0], t[1]);
+            triangles_.insert(triangles_.end(), t, t + 3);
+         }
+         break;
+
+      case GL_QUAD_STRIP:
+         for (size_t i = 3; i < n; i += 2)
+         {
+            GLuint t[] = { v[i - 3], v[i - 2], v[i], v[i - 3], v[i], v[i - 1] };
+            triangles_.insert(triangles_.end(), t, t + 6);
+         }
+         break;
+
+      case GL_TRIANGLE_FAN:
+      case GL_POLYGON:
+         for (size_t i = 2; i < n; ++i)
+         {
+            GLuint t[] = { v[0], v[i - 1], v[i] };
+            triangles_.insert(triangles_.end(), t, t + 3);
+         }
+         break;
+
+      default:
+         break;
    }
 }
 
+void Mesh::destroy()
+{
+   if (display_list_id_ != 0)
+   {
+      glDeleteLists(display_list_id_, 1);
+      display_list_id_ = 0;
+   }
+
+   if (vertex_array_id_ != 0)
+   {
+      gl::deleteVertexArrays(1, &vertex_array_id_);
+      vertex_array_id_ = 0;
+   }
+
+   if (vertex_buffer_id_ != 0)
+   {
+      gl::deleteBuffers(1, &vertex_buffer_id_);
+      vertex_buffer_id_ = 0;
+   }
+
+   if (index_buffer_id_ != 0)
+   {
+      gl::deleteBuffers(1, &index_buffer_id_);
+      index_buffer_id_ = 0;
+   }
+}
+
+// Points the fixed-function vertex arrays at the mesh's buffers.
+void Mesh::bindBuffers() const
+{
+   const GLsizei stride = sizeof(Vertex);
+
+   gl::bindBuffer(GL_ARRAY_BUFFER, vertex_buffer_id_);
+   gl::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_id_);
+
+   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+   glEnableClientState(GL_NORMAL_ARRAY);
+   glEnableClientState(GL_VERTEX_ARRAY);
+
+   glTexCoordPointer(3, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(Vertex, texture_coord)));
+   glNormalPointer(GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(Vertex, normal)));
+   glVertexPointer(3, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(offsetof(Vertex, position)));
+}
+
+// Other drawing code (including SFML's) uses client-side vertex arrays, which
+// would be read from the mesh's buffers if they were left bound.
+void Mesh::unbindBuffers() const
+{
+   glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+   glDisableClientState(GL_NORMAL_ARRAY);
+   glDisableClientState(GL_VERTEX_ARRAY);
+
+   gl::bindBuffer(GL_ARRAY_BUFFER, 0);
+   gl::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
 } // namespace carcassonne::gfx
 } // namespace carcassonne
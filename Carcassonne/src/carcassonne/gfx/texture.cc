@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <vector>
 
 #include "stb_image.h"
 
@@ -33,10 +34,29 @@
 namespace carcassonne {
 namespace gfx {
 
-Texture::State Texture::state_(UNKNOWN);
-GLuint Texture::bound_id_(0);
-GLenum Texture::mode_(GL_MODULATE);
-glm::vec4 Texture::color_(0,0,0,0);
+namespace {
+
+enum State { UNKNOWN, DISABLED, ENABLED };
+
+// The texturing state of the OpenGL context, so redundant state changes can
+// be skipped.  A context can only be current on one thread at a time, so
+// each thread keeps its own copy; games rendered on different threads (with
+// different contexts) don't share it.  It has to be POD to be thread-local.
+struct ContextState
+{
+   State state;
+   GLuint bound_id;
+   GLenum mode;
+   GLfloat color[4];
+};
+
+#ifdef _MSC_VER
+__declspec(thread) ContextState context = { UNKNOWN, 0, GL_MODULATE, { 0, 0, 0, 0 } };
+#else
+__thread ContextState context = { UNKNOWN, 0, GL_MODULATE, { 0, 0, 0, 0 } };
+#endif
+
+} // namespace
 
 Texture::Texture(db::DB& db, const std::string& name)
    : db_(db),
@@ -46,27 +66,58 @@ Texture::Texture(db::DB& db, const std::string& name)
    init();
 }
 
+// Creates a texture from pixels which aren't in the database (e.g. a
+// TextureAtlas).  init() can't reload it; use init(size, data) instead.
+Texture::Texture(db::DB& db, const std::string& name, const glm::ivec2& size, const GLubyte* data)
+   : db_(db),
+     name_(name),
+     texture_id_(0)
+{
+   init(size, data);
+}
+
 void Texture::init()
+{
+   std::vector<GLubyte> pixels;
+   glm::ivec2 size;
+   loadPixels(db_, name_, size, pixels);
+
+   init(size, &pixels[0]);
+}
+
+void Texture::init(const glm::ivec2& size, const GLubyte* data)
 {
    if (texture_id_ != 0)
    {
-      if (bound_id_ == texture_id_)
-         bound_id_ = 0;
+      if (context.bound_id == texture_id_)
+         context.bound_id = 0;
 
       glDeleteTextures(1, &texture_id_);
+      texture_id_ = 0;
    }
 
-   db::Stmt stmt(db_, "SELECT format, width, height, data "
+   if (size.x <= 0 || size.y <= 0)
+      throw std::runtime_error("Texture must have nonzero width and height!");
+
+   size_ = size;
+   upload(data);
+}
+
+// Loads the texture named name from the database and decodes it to 32-bit
+// RGBA pixels, without creating an OpenGL texture.
+void Texture::loadPixels(db::DB& db, const std::string& name, glm::ivec2& size, std::vector<GLubyte>& pixels)
+{
+   db::Stmt stmt(db, "SELECT format, width, height, data "
                      "FROM cc_textures "
                      "WHERE name = ? LIMIT 1");
-   stmt.bind(1, name_);
+   stmt.bind(1, name);
    if (!stmt.step())
       throw db::DB::error("Texture not found!");
 
    std::string format = stmt.getText(0);
    std::transform(format.begin(), format.end(), format.begin(), tolower);
-   size_.x = stmt.getInt(1);
-   size_.y = stmt.getInt(2);
+   size.x = stmt.getInt(1);
+   size.y = stmt.getInt(2);
 
    const void* data;
    void* stbi_data = nullptr;
@@ -75,7 +126,7 @@ void Texture::init()
    {
       int length = stmt.getBlob(3, data);
 
-      if (size_.x * size_.y * 4 > length)
+      if (size.x * size.y * 4 > length)
          throw std::runtime_error("Raw texture data corrupted or incomplete!");
    }
    else
@@ -85,17 +136,23 @@ void Texture::init()
       int comps;
 
       stbi_data = stbi_load_from_memory(static_cast<const stbi_uc*>(data),
-                                        length, &size_.x, &size_.y, &comps, 4);
+                                        length, &size.x, &size.y, &comps, 4);
       if (stbi_data == nullptr)
          throw std::runtime_error(stbi_failure_reason());
 
       data = stbi_data;
    }
 
-   if (size_.x <= 0 || size_.y <= 0)
+   if (size.x <= 0 || size.y <= 0)
+   {
+      if (stbi_data != nullptr)
+         stbi_image_free(stbi_data);
+
       throw std::runtime_error("Texture must have nonzero width and height!");
+   }
 
-   upload(static_cast<const GLubyte*>(data));
+   const GLubyte* begin = static_cast<const GLubyte*>(data);
+   pixels.assign(begin, begin + size.x * size.y * 4);
 
    if (stbi_data != nullptr)
       stbi_image_free(stbi_data);
@@ -126,8 +183,8 @@ Texture::~Texture()
 {
    if (texture_id_ != 0)
    {
-      if (bound_id_ == texture_id_)
-         bound_id_ = 0;
+      if (context.bound_id == texture_id_)
+         context.bound_id = 0;
 
       glDeleteTextures(1, &texture_id_);
    }
@@ -161,10 +218,11 @@ void Texture::enable(GLenum mode, const glm::vec4& color) const
    checkUnknown();
    checkMode(mode);
 
-   if (color != color_)
+   if (color != glm::vec4(context.color[0], context.color[1], context.color[2], context.color[3]))
    {
       glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, &(color.r));
-      color_ = color;
+      for (int i = 0; i < 4; ++i)
+         context.color[i] = color[i];
    }
 
    checkTexture();
@@ -173,56 +231,56 @@ void Texture::enable(GLenum mode, const glm::vec4& color) const
 void Texture::disable() const
 {
    checkUnknown();
-   if (state_ == ENABLED && bound_id_ == texture_id_)
+   if (context.state == ENABLED && context.bound_id == texture_id_)
    {
       glDisable(GL_TEXTURE_2D);
-      state_ = DISABLED;
+      context.state = DISABLED;
    }
 }
 
 void Texture::disableAny()
 {
    checkUnknown();
-   if (state_ == ENABLED)
+   if (context.state == ENABLED)
    {
       glDisable(GL_TEXTURE_2D);
-      state_ = DISABLED;
+      context.state = DISABLED;
    }
 }
 
 void Texture::checkUnknown()
 {
-   if (state_ == UNKNOWN)
+   if (context.state == UNKNOWN)
    {
-      state_ = DISABLED;
+      context.state = DISABLED;
       
       glDisable(GL_TEXTURE_2D);
-      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, mode_);
-      glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, &(color_.r));
+      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, context.mode);
+      glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, context.color);
    }
 }
 
 void Texture::checkTexture() const
 {
-   if (bound_id_ != texture_id_)
+   if (context.bound_id != texture_id_)
    {
       glBindTexture(GL_TEXTURE_2D, texture_id_);
-      bound_id_ = texture_id_;
+      context.bound_id = texture_id_;
    }
 
-   if (state_ == DISABLED)
+   if (context.state == DISABLED)
    {
       glEnable(GL_TEXTURE_2D);
-      state_ = ENABLED;
+      context.state = ENABLED;
    }
 }
 
 void Texture::checkMode(GLenum mode)
 {
-   if (mode_ != mode)
+   if (context.mode != mode)
    {
       glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, mode);
-      mode_ = mode;
+      context.mode = mode;
    }
 }
 
@@ -0,0 +1,152 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/gfx/texture_atlas.cc
+//
+// Several textures packed into the cells of one larger texture.
+
+#include "carcassonne/gfx/texture_atlas.h"
+
+#include <algorithm>
+
+#include "carcassonne/gfx/gl_functions.h"
+
+namespace carcassonne {
+namespace gfx {
+
+namespace {
+
+int nextPowerOfTwo(int n)
+{
+   int p = 1;
+   while (p < n)
+      p *= 2;
+
+   return p;
+}
+
+} // namespace
+
+TextureAtlas::TextureAtlas(db::DB& db, const std::string& name, const std::vector<std::string>& textures,
+                           const GraphicsConfiguration& gfx_cfg)
+   : db_(db),
+     name_(name),
+     textures_(textures),
+     gfx_cfg_(gfx_cfg)
+{
+   if (textures_.empty())
+      throw std::runtime_error("Texture atlas must have at least one layer!");
+
+   init();
+}
+
+// The textures are loaded from the database again rather than keeping the
+// composed atlas in memory.
+void TextureAtlas::init()
+{
+   glm::ivec2 size;
+   std::vector<GLubyte> pixels;
+   build(size, pixels);
+
+   GLint max_size = 0;
+   glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+   if (size.x > max_size || size.y > max_size)
+      throw std::runtime_error("Texture atlas is too large!");
+
+   if (texture_)
+      texture_->init(size, &pixels[0]);
+   else
+      texture_.reset(new Texture(db_, name_, size, &pixels[0]));
+}
+
+const std::string& TextureAtlas::getName() const
+{
+   return name_;
+}
+
+const Texture& TextureAtlas::getTexture() const
+{
+   return *texture_;
+}
+
+size_t TextureAtlas::getLayerCount() const
+{
+   return textures_.size();
+}
+
+const glm::vec4& TextureAtlas::getLayerRect(size_t layer) const
+{
+   return rects_[layer];
+}
+
+// The cells are laid out in a roughly square grid, each big enough for the
+// largest texture.  Before OpenGL 2.0 textures must have power-of-two sizes.
+void TextureAtlas::build(glm::ivec2& size, std::vector<GLubyte>& pixels)
+{
+   std::vector<std::vector<GLubyte> > layers(textures_.size());
+   std::vector<glm::ivec2> layer_sizes(textures_.size());
+
+   glm::ivec2 cell;
+   for (size_t i = 0; i < textures_.size(); ++i)
+   {
+      Texture::loadPixels(db_, textures_[i], layer_sizes[i], layers[i]);
+      cell = glm::max(cell, layer_sizes[i]);
+   }
+   cell += glm::ivec2(2 * GUTTER, 2 * GUTTER);
+
+   int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(textures_.size()))));
+   int rows = (static_cast<int>(textures_.size()) + columns - 1) / columns;
+
+   size = glm::ivec2(columns * cell.x, rows * cell.y);
+   if (!gl::isVersionAtLeast(gfx_cfg_.gl_version_major, gfx_cfg_.gl_version_minor, 2, 0))
+      size = glm::ivec2(nextPowerOfTwo(size.x), nextPowerOfTwo(size.y));
+
+   pixels.assign(size.x * size.y * 4, 0);
+   rects_.resize(textures_.size());
+
+   for (size_t i = 0; i < textures_.size(); ++i)
+   {
+      const glm::ivec2& layer_size = layer_sizes[i];
+      const GLubyte* src = &layers[i][0];
+
+      glm::ivec2 origin(static_cast<int>(i) % columns * cell.x + GUTTER,
+                        static_cast<int>(i) / columns * cell.y + GUTTER);
+
+      for (int y = -GUTTER; y < layer_size.y + GUTTER; ++y)
+      {
+         int src_y = std::min(std::max(y, 0), layer_size.y - 1);
+         for (int x = -GUTTER; x < layer_size.x + GUTTER; ++x)
+         {
+            int src_x = std::min(std::max(x, 0), layer_size.x - 1);
+
+            const GLubyte* from = src + (src_y * layer_size.x + src_x) * 4;
+            GLubyte* to = &pixels[((origin.y + y) * size.x + origin.x + x) * 4];
+            std::copy(from, from + 4, to);
+         }
+      }
+
+      rects_[i] = glm::vec4(float(origin.x) / size.x, float(origin.y) / size.y,
+                            float(layer_size.x) / size.x, float(layer_size.y) / size.y);
+   }
+}
+
+} // namespace carcassonne::gfx
+} // namespace carcassonne
@@ -24,6 +24,7 @@
 #include "carcassonne/gui/main_menu.h"
 
 #include <sstream>
+#include <ctime>
 
 #include "carcassonne/game.h"
 #include "carcassonne/asset_manager.h"
@@ -186,6 +187,11 @@ void MainMenu::nextPlayerType(int player)
          break;
 
       case MACHINE:
+         player_types[player] = MACHINE_HARD;
+         oss << "Hard Machine";
+         break;
+
+      case MACHINE_HARD:
          player_types[player] = NONE;
          oss << "None";
          break;
@@ -201,18 +207,20 @@ void MainMenu::nextPlayerType(int player)
 void MainMenu::newGame()
 {
    ScenarioInit sci;
+   sci.context.reset(new GameContext(static_cast<unsigned int>(time(nullptr))));
 
    for (int i = 0; i < 6; ++i)
    {
       if (player_types[i] != NONE)
       {
-         sci.players.push_back(game_.getPlayer(i));
-         sci.players.back()->setHuman(player_types[i] == HUMAN);
-         sci.players.back()->newScenario(game_.getAssetManager(), sci.players.back()->getColor());
+         Player* profile = game_.getPlayer(i);
+         profile->setHuman(player_types[i] == HUMAN);
+         profile->setSkillLevel(player_types[i] == MACHINE_HARD ? Player::SKILL_LEVEL_HARD : Player::SKILL_LEVEL_NORMAL);
+         sci.context->addPlayer(*profile);
       }
    }
 
-   Pile p = game_.getAssetManager().getTileSet("std-base");
+   Pile p = game_.getAssetManager().getTileSet("std-base", sci.context->nextSeed());
    sci.starting_tile = p.remove();
    p.shuffle();
    sci.tiles = std::move(p);
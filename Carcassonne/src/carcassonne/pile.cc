@@ -25,65 +25,91 @@
 
 #include "carcassonne/pile.h"
 
-#include <ctime>
-
-#include "carcassonne/asset_manager.h"
-#include "carcassonne/db/stmt.h"
+#include "carcassonne/zobrist.h"
 
 namespace carcassonne {
 
-Pile::Pile()
-   : prng_(static_cast<std::mt19937::result_type>(time(nullptr)))
-{
-}
-
 Pile::Pile(unsigned int seed)
-   : prng_(static_cast<std::mt19937::result_type>(seed))
+   : prng_(static_cast<std::mt19937::result_type>(seed)),
+     hash_(0)
 {
 }
 
 Pile::Pile(Pile&& other)
-   : prng_(static_cast<std::mt19937::result_type>(time(nullptr)))
+   : prng_(other.prng_),
+     hash_(0)
 {
    add(std::move(other));
 }
 
 Pile& Pile::operator=(Pile&& other)
 {
+   prng_ = other.prng_;
+   tileset_ = std::move(other.tileset_);
    tiles_ = std::move(other.tiles_);
+   returned_ = std::move(other.returned_);
+   spares_ = std::move(other.spares_);
+   counts_ = std::move(other.counts_);
+   fitting_counts_ = std::move(other.fitting_counts_);
+   hash_ = other.hash_;
+   other.hash_ = 0;
+   features_pool_ = std::move(other.features_pool_);
    return *this;
 }
 
-Pile::Pile(AssetManager& asset_mgr, const std::string& tileset_name)
-   : prng_(static_cast<std::mt19937::result_type>(time(nullptr)))
+Pile::Pile(const std::shared_ptr<const Tileset>& tileset, unsigned int seed)
+   : prng_(static_cast<std::mt19937::result_type>(seed)),
+     tileset_(tileset),
+     hash_(0)
 {
-   db::DB& db = asset_mgr.getDB();
-
-   db::Stmt s(db, "SELECT id, starting_tile FROM cc_tilesets WHERE name = ?");
-   s.bind(1, tileset_name);
-   if (!s.step())
-      throw std::runtime_error("Tileset not found!");
+   fill();
+}
 
-   db::Stmt st(db, "SELECT tile, quantity FROM cc_tileset_tiles WHERE tileset_id = ?");
-   st.bind(1, s.getInt(0));
-   while (st.step())
-   {
-      Tile* tile = new Tile(asset_mgr, st.getText(0));
-      tiles_.push_back(std::unique_ptr<Tile>(tile));
+Pile::Pile(db::DB& db, const std::string& tileset_name, unsigned int seed)
+   : prng_(static_cast<std::mt19937::result_type>(seed)),
+     tileset_(std::make_shared<Tileset>(db, tileset_name)),
+     hash_(0)
+{
+   fill();
+}
 
-      // copy tile until quantity required has been added
-      int quantity = st.getInt(1);
-      while (--quantity > 0)
-         tiles_.push_back(std::unique_ptr<Tile>(new Tile(*tile)));
-   }
+Pile::Pile(const Pile& other, unsigned int seed)
+   : prng_(static_cast<std::mt19937::result_type>(seed)),
+     tileset_(other.tileset_),
+     tiles_(other.tiles_),
+     hash_(0)
+{
+   // other's returned tiles stay with other
+   for (auto i(tiles_.begin()), end(tiles_.end()); i != end; ++i)
+      i->returned = false;
 
-   // starting tile goes on last
-   tiles_.push_back(std::unique_ptr<Tile>(new Tile(asset_mgr, s.getText(1))));
+   shuffle();
+   rehash();
 }
 
-void Pile::setSeed()
+// Adds quantity copies of each tile in the tileset, each with a random
+// starting rotation.  The starting tile goes on last.
+void Pile::fill()
 {
-   prng_.seed(static_cast<std::mt19937::result_type>(time(nullptr)));
+   for (size_t i = 0; i < tileset_->size(); ++i)
+   {
+      for (int quantity = tileset_->getQuantity(i); quantity > 0; --quantity)
+      {
+         Entry entry;
+         entry.prototype = i;
+         entry.rotation = static_cast<Tile::Rotation>(prng_() % 4);
+         entry.returned = false;
+         tiles_.push_back(entry);
+      }
+   }
+
+   Entry entry;
+   entry.prototype = tileset_->getStartingTile();
+   entry.rotation = static_cast<Tile::Rotation>(prng_() % 4);
+   entry.returned = false;
+   tiles_.push_back(entry);
+
+   rehash();
 }
 
 void Pile::setSeed(unsigned int seed)
@@ -91,22 +117,42 @@ void Pile::setSeed(unsigned int seed)
    prng_.seed(static_cast<std::mt19937::result_type>(seed));
 }
 
-void Pile::add(std::unique_ptr<Tile>&& tile)
+void Pile::add(Pile&& other)
 {
-   tiles_.push_back(std::move(tile));
+   if (!tileset_)
+      tileset_ = other.tileset_;
+   else if (other.tileset_ && other.tileset_ != tileset_ && !other.tiles_.empty())
+      throw std::runtime_error("Can't combine piles from different tilesets!");
+
+   if (!features_pool_)
+      features_pool_ = other.features_pool_;
+
+   clearReturned();
+   other.clearReturned();
+   tiles_.insert(tiles_.end(), other.tiles_.begin(), other.tiles_.end());
+   other.tiles_.clear();
+
+   rehash();
+   other.rehash();
 }
 
-void Pile::add(Pile&& other)
+void Pile::add(const TilePrototype& prototype, Tile::Rotation rotation)
 {
-   for (auto i(other.tiles_.begin()), end(other.tiles_.end()); i != end; ++i)
-   {
-      tiles_.push_back(std::move(*i));
-   }
-   other.tiles_.clear();
+   if (!tileset_ || &tileset_->getPrototype(prototype.index) != &prototype)
+      throw std::runtime_error("Can't add a tile from a different tileset!");
+
+   Entry entry;
+   entry.prototype = prototype.index;
+   entry.rotation = rotation;
+   entry.returned = false;
+   tiles_.push_back(entry);
+   count(entry.prototype, 1);
 }
 
 void Pile::shuffle()
 {
+   clearReturned();
+
    for (size_t i = 0; i < tiles_.size(); ++i)
    {
       size_t j = i + prng_() % (tiles_.size() -i);
@@ -119,16 +165,143 @@ int Pile::size() const
    return tiles_.size();
 }
 
+const std::shared_ptr<const Tileset>& Pile::getTileset() const
+{
+   return tileset_;
+}
+
+unsigned long long Pile::getHash() const
+{
+   return hash_;
+}
+
+const std::vector<int>& Pile::getCounts() const
+{
+   return counts_;
+}
+
+int Pile::getFittingCount(unsigned char constraints) const
+{
+   return fitting_counts_.empty() ? 0 : fitting_counts_[constraints];
+}
+
+bool Pile::moveToTop(size_t prototype)
+{
+   for (size_t i = tiles_.size(); i > 0; --i)
+   {
+      Entry& entry = tiles_[i - 1];
+      if (entry.prototype != static_cast<int>(prototype))
+         continue;
+
+      if (i < tiles_.size())
+      {
+         // returned tiles have to stay in the order they were put back
+         if (entry.returned || tiles_.back().returned)
+            clearReturned();
+
+         std::swap(entry, tiles_.back());
+      }
+      return true;
+   }
+
+   return false;
+}
+
 std::unique_ptr<Tile> Pile::remove()
 {
    if (tiles_.size() == 0)
       return std::unique_ptr<Tile>();
 
-   std::unique_ptr<Tile> tile = std::move(tiles_.back());
-
+   Entry entry = tiles_.back();
    tiles_.pop_back();
+   count(entry.prototype, -1);
+
+   if (entry.returned)
+   {
+      std::unique_ptr<Tile> tile(std::move(returned_.back()));
+      returned_.pop_back();
+      return tile;
+   }
+
+   if (static_cast<size_t>(entry.prototype) < spares_.size() && !spares_[entry.prototype].empty())
+   {
+      std::unique_ptr<Tile> tile(std::move(spares_[entry.prototype].back()));
+      spares_[entry.prototype].pop_back();
+
+      // spares are floating, so they can still be rotated
+      for (int i = 0; i < 4 && tile->getRotation() != entry.rotation; ++i)
+         tile->rotateClockwise();
+
+      return tile;
+   }
+
+   // shares ownership of the tileset
+   std::shared_ptr<const TilePrototype> prototype(tileset_, &tileset_->getPrototype(entry.prototype));
+
+   if (!features_pool_)
+      features_pool_ = std::make_shared<features::FeaturePool>();
+
+   return std::unique_ptr<Tile>(new Tile(prototype, entry.rotation, features_pool_));
+}
+
+void Pile::putBack(std::unique_ptr<Tile>&& tile)
+{
+   if (!tile)
+      return;
+
+   Entry entry;
+   entry.prototype = tile->getPrototype().index;
+   entry.rotation = tile->getRotation();
+   entry.returned = true;
+   tiles_.push_back(entry);
+   count(entry.prototype, 1);
+
+   returned_.push_back(std::move(tile));
+}
+
+void Pile::clearReturned()
+{
+   if (returned_.empty())
+      return;
+
+   for (auto i(tiles_.begin()), end(tiles_.end()); i != end; ++i)
+      i->returned = false;
+
+   if (spares_.size() < tileset_->size())
+      spares_.resize(tileset_->size());
+
+   for (auto i(returned_.begin()), end(returned_.end()); i != end; ++i)
+   {
+      Tile& tile = **i;
+      spares_[tile.getPrototype().index].push_back(std::move(*i));
+   }
+
+   returned_.clear();
+}
+
+void Pile::rehash()
+{
+   counts_.assign(tileset_ ? tileset_->size() : 0, 0);
+   fitting_counts_.assign(256, 0);
+   hash_ = 0;
+
+   for (auto i(tiles_.begin()), end(tiles_.end()); i != end; ++i)
+      count(i->prototype, 1);
+}
+
+// Each prototype fits at most 63 kinds of empty location (see
+// TilePrototype::fitting_constraints), so the cost of a draw doesn't depend
+// on the size of the pile or the board.
+void Pile::count(int prototype, int delta)
+{
+   int& n = counts_[prototype];
+   hash_ ^= zobrist::pile(prototype, n);
+   n += delta;
+   hash_ ^= zobrist::pile(prototype, n);
 
-   return std::move(tile);
+   const std::vector<unsigned char>& fitting = tileset_->getPrototype(prototype).fitting_constraints;
+   for (auto i(fitting.begin()), end(fitting.end()); i != end; ++i)
+      fitting_counts_[*i] += delta;
 }
 
-} // namespace carcassonne
\ No newline at end of file
+} // namespace carcassonne
@@ -23,14 +23,14 @@
 //
 // Represents a human or AI player, including name and win/loss record, and
 // skill level (for AI players).  Additionally, the player class stores
-// some information specific to the current scenario (game).
+// some information specific to the current scenario (game).  The players
+// owned by Game are profiles; each game plays with its own copies (see
+// GameContext).
 
 #include "carcassonne/player.h"
 
 #include <sstream>
 
-#include "carcassonne/asset_manager.h"
-
 namespace carcassonne {
 
 Player::Player(const std::string& name, bool human)
@@ -40,7 +40,8 @@ Player::Player(const std::string& name, bool human)
      wins_(0),
      losses_(0),
      games_played_(0),
-     high_score_(0)
+     high_score_(0),
+     score_(0)
 {
 }
 
@@ -59,20 +60,25 @@ bool Player::isHuman() const
    return human_;
 }
 
+void Player::setSkillLevel(SkillLevel skill_level)
+{
+   skill_level_ = skill_level;
+}
+
 Player::SkillLevel Player::getSkillLevel() const
 {
-   return Player::SKILL_LEVEL_TRIVIAL;
+   return skill_level_;
 }
 
-void Player::recordScenarioResult(bool won)
+void Player::recordScenarioResult(bool won, int score)
 {
    games_played_++;
    if(won)
       wins_++;
    else
       losses_++;
-   if(high_score_ < score_)
-      high_score_ = score_;
+   if(high_score_ < score)
+      high_score_ = score;
 }
 
 int Player::getWins() const
@@ -102,15 +108,13 @@ int Player::getHighScore() const
 
 // Specific to current game:
 
-void Player::newScenario(AssetManager& asset_mgr, const glm::vec4& color)
+void Player::newScenario(const glm::vec4& color)
 {
-   
-
    color_ = color;
    followers_.clear();
    for (int i = 0; i < 7; ++i)
    {
-      followers_.push_back(Follower(asset_mgr, *this));
+      followers_.push_back(Follower(*this));
       followers_.back().setIdle(true);
    }
 
@@ -165,12 +169,15 @@ void Player::organizeIdleFollowers()
    }
 }
 
+const std::vector<Follower>& Player::getFollowers() const
+{
+   return followers_;
+}
+
 // increase score_;
 void Player::scorePoints(int points)
 {
    score_ += points;
-
-   std::cout << getName() << " scored " << points << " points!  Score: " << score_ << std::endl;
 }
 
 int Player::getScore() const
@@ -178,27 +185,4 @@ int Player::getScore() const
    return score_;
 }
 
-// display this player's HUD if it's their turn
-void Player::draw() const
-{
-   glPushMatrix();
-   glTranslatef(0.0f, 0.95f, 0.0f);
-   glScalef(0.15f, -0.15f, 0.15f);
-
-   for (auto i(followers_.begin()), end(followers_.end()); i != end; ++i)
-      if (i->isIdle() && !i->isFloating())
-         i->draw();
-
-   glPopMatrix();
-}
-
-void Player::drawPlacedFollowers() const
-{
-   for (auto i(followers_.begin()), end(followers_.end()); i != end; ++i)
-   {
-      if (i->isPlaced())
-         i->draw();
-   }
-}
-
 } // namespace carcassonne
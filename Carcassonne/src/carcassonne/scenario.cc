@@ -46,13 +46,13 @@ Scenario::Scenario(Game& game, ScenarioInit& options)
      font_(game.getAssetManager().getTextureFont("kingthings")),
      min_simulate_interval_(sf::milliseconds(5)),
      paused_(false),
-     board_(game.getAssetManager()),
-     draw_pile_(std::move(options.tiles)),
-     players_(options.players),
-     current_player_(players_.end()),
-     current_follower_(nullptr),
-     last_placed_tile_(nullptr),
-     game_over_(false)
+     show_render_stats_(false),
+     context_(std::move(options.context)),
+     state_(context_->getPlayers(), std::move(options.tiles), std::move(options.starting_tile)),
+     renderer_(game.getAssetManager()),
+     machine_search_(game.getAiConfiguration().getSearchOptions(), game.getAiConfiguration().getSolverOptions()),
+     machine_thinking_(false),
+     machine_evaluator_(game.getAiConfiguration().weights)
 {
    // set InputManager callbacks
    input_mgr_.setMouseHoverHandler(                   ([=](){ onHover(); }));
@@ -75,140 +75,73 @@ Scenario::Scenario(Game& game, ScenarioInit& options)
    scheduling::PersistentSequence* seq = &simulation_sequence_;
    simulation_unifier_.schedule([=] (sf::Time t) { return (*seq)(t); });
 
-   assert(players_.size() > 1);
-
-   board_.placeTileAt(glm::ivec2(0,0), std::move(options.starting_tile));
-   endTurn();
+   onTurnChanged();
 }
 
 Player& Scenario::getCurrentPlayer()
 {
-   return **current_player_;
+   return state_.getCurrentPlayer();
 }
 
 const Player& Scenario::getCurrentPlayer() const
 {
-   return **current_player_;
+   return state_.getCurrentPlayer();
 }
 
 // switches to follower placement
 void Scenario::placeTile(const glm::ivec2& board_coords)
 {
-   last_placed_tile_ = current_tile_.get();
-   if (!board_.placeTileAt(board_coords, std::move(current_tile_)))
-   {
-      last_placed_tile_ = nullptr;
-      return;
-   }
-   current_tile_.reset();
-
-   Follower* follower = getCurrentPlayer().getIdleFollower();
-   if (follower != nullptr)
-   {
-      bool found_placeholder(false);
-      for (size_t i = 0; i < last_placed_tile_->getFeatureCount(); ++i)
-      {
-         std::shared_ptr<features::Feature> feature = last_placed_tile_->getFeature(i).lock();
-         if (feature->hasPlaceholder())
-         {
-            found_placeholder = true;
-            glm::vec4 color(follower->getOwner()->getColor());
-            feature->setPlaceholderColor(color);
-            follower_placeholders_.push_back(feature);
-         }
-      }
-      if (found_placeholder)
-      {
-         current_follower_ = follower;
-         follower->setFloating(true);
-         onHover();
-         return;  // don't end turn
-      }
-   }
-
-   endTurn();
+   if (state_.placeTile(board_coords))
+      onTurnChanged();
 }
 
 void Scenario::placeFollower(const glm::vec3& world_coords, bool limit_distance)
 {
-   glm::vec3& tile_coords(last_placed_tile_->worldToLocal(world_coords));
-
-   features::Feature* closest_feature(nullptr);
-   float closest_placeholder_distance(limit_distance ? 1.0f : -1.0f);
-   for (auto i(follower_placeholders_.begin()), end(follower_placeholders_.end()); i != end; ++i)
-   {
-      features::Feature* feature = i->get();
-      const Follower* follower = feature->getPlaceholder();
-      float distance(glm::distance(tile_coords, follower->getPosition()));
-
-      if (closest_placeholder_distance < 0 || closest_placeholder_distance > distance)
-      {
-         closest_placeholder_distance = distance;
-         closest_feature = feature;
-      }
-   }
-
-   if (closest_feature)
-      closest_feature->placeFollower(*current_follower_, *last_placed_tile_);
-   else
-      current_follower_->setIdle(true);
-   
-   endTurn();
+   state_.placeFollower(state_.getNearestPlaceholder(world_coords, limit_distance));
+   onTurnChanged();
 }
 
-void Scenario::endTurn()
+// called after the GameState moves to a new phase of a turn (or a new turn)
+void Scenario::onTurnChanged()
 {
-   if (last_placed_tile_)
-      last_placed_tile_->checkForCompleteFeatures();
-
-   // move current_player_ to the next player
-   if (current_player_ == players_.end())
-      current_player_ = players_.begin();
-   else
-   {
-      ++current_player_;
-      if (current_player_ == players_.end())
-         current_player_ = players_.begin();
-   }
-   camera_movement_enabled_ = (**current_player_).isHuman();
-
-   // set current_tile_
-   current_tile_ = draw_pile_.remove();
-
-   while (current_tile_)
-   {
-      if (board_.usingNewTile(*current_tile_))
-         break;
-
-      // if the current tile isn't placeable anywhere, get a new tile and discard the old one
-      current_tile_ = draw_pile_.remove();
-   }
+   renderer_.update(state_);
+   camera_movement_enabled_ = getCurrentPlayer().isHuman();
+   onHover();
 
-   if (!current_tile_)
+   if (state_.isGameOver())
    {
-      board_.scoreAllTiles();
+      context_->recordResults();
 
       std::cout << "Game Over!" <<std::endl;
       int p = 1;
-      for (auto i(players_.begin()), end(players_.end()); i != end; ++i)
+      const std::vector<Player*>& players = state_.getPlayers();
+      for (auto i(players.begin()), end(players.end()); i != end; ++i)
       {
          std::cout << "Player " << p << ": " << (*i)->getScore() << " points" << std::endl;
          ++p;
       }
-      game_over_ = true;
    }
+}
 
-   
+// Called each frame while a machine player is thinking.  Plays the move once
+// the search is done.  If it was cancelled (e.g. the game was paused), the
+// search starts again on the next frame.
+bool Scenario::finishMachineTurn()
+{
+   if (machine_search_.isRunning())
+      return false;
 
-   // set current_follower_
-   current_follower_ = nullptr;
-   last_placed_tile_ = nullptr;
-   follower_placeholders_.clear();
+   machine_thinking_ = false;
+   if (machine_search_.hasMove())
+   {
+      std::cout << getCurrentPlayer().getName() << ": " << machine_search_.getReport() << std::endl;
+      state_.apply(machine_search_.getMove());
+      onTurnChanged();
+   }
 
-   onHover();
+   return true;
 }
 
-
 void Scenario::zoom(float factor, bool lock_xz)
 {
    if (!camera_movement_enabled_)
@@ -243,24 +176,22 @@ void Scenario::draw() const
    glEnable(GL_DEPTH_TEST);
    glEnable(GL_CULL_FACE);
    
-   board_.draw();
+   gfx::Frustum frustum(camera_.getViewProjection());
+
+   renderer_.drawBoard(frustum);
    
-   if (getCurrentPlayer().isHuman() && current_tile_)
-      board_.drawEmpyTiles();
+   if (getCurrentPlayer().isHuman() && state_.getCurrentTile())
+      renderer_.drawEmptyTiles(state_.getBoard(), frustum);
 
-   if (current_follower_)
+   if (state_.getCurrentFollower())
    {
-      last_placed_tile_->drawPlaceholders();
-      current_follower_->draw();
+      renderer_.drawPlaceholders();
+      renderer_.drawFollower(*state_.getCurrentFollower());
    }
-   else if (current_tile_)
-      current_tile_->draw();
+   else if (state_.getCurrentTile())
+      renderer_.drawTile(*state_.getCurrentTile());
 
-   for (auto i(players_.begin()), end(players_.end()); i != end; ++i)
-   {
-      Player& p = **i;
-      p.drawPlacedFollowers();
-   }
+   renderer_.drawPlacedFollowers(frustum);
    
    glDisable(GL_LIGHTING);
    glDisable(GL_DEPTH_TEST);
@@ -275,7 +206,7 @@ void Scenario::draw() const
    glScalef(0.3f, 0.3f, 0.3f);
 
    std::ostringstream oss;
-   oss << draw_pile_.size() << " tiles remain";
+   oss << state_.getDrawPile().size() << " tiles remain";
    float w = font_->getWidth(oss.str());
    glTranslatef(-(w + 0.1f), 0.15f, 0.0f);
    glColor4f(1,1,1,0.5);
@@ -283,17 +214,64 @@ void Scenario::draw() const
 
    glPopMatrix();
 
+   // draw how many of the remaining tiles fit where the current tile is
+   if (getCurrentPlayer().isHuman() && state_.getCurrentTile())
+   {
+      const Board& board = state_.getBoard();
+      glm::ivec2 location(board.getCoordinates(state_.getCurrentTile()->getPosition()));
+
+      if (board.getConstraints(location) != 0)
+      {
+         glPushMatrix();
+         glTranslatef(expanded.right(), 0.0f, 0.0f);
+         glScalef(0.3f, 0.3f, 0.3f);
+
+         std::ostringstream oss;
+         oss << state_.getFittingTileCount(location) << " fit here";
+         float w = font_->getWidth(oss.str());
+         glTranslatef(-(w + 0.1f), 0.3f, 0.0f);
+         glColor4f(1,1,1,0.5);
+         font_->print(oss.str(), GL_MODULATE);
+
+         glPopMatrix();
+      }
+   }
+
+   // draw how much of the board was culled
+   if (show_render_stats_)
+   {
+      const gfx::BoardRenderer::Stats& stats = renderer_.getStats();
+
+      glPushMatrix();
+      glTranslatef(expanded.right(), 0.0f, 0.0f);
+      glScalef(0.3f, 0.3f, 0.3f);
+
+      std::ostringstream oss;
+      oss << "drawn/culled: "
+          << stats.chunks_drawn << '/' << stats.chunks_culled << " chunks, "
+          << stats.tiles_drawn << '/' << stats.tiles_culled << " tiles, "
+          << stats.followers_drawn << '/' << stats.followers_culled << " followers, "
+          << stats.empty_tiles_drawn << '/' << stats.empty_tiles_culled << " empty";
+      float w = font_->getWidth(oss.str());
+      glTranslatef(-(w + 0.1f), 0.45f, 0.0f);
+      glColor4f(1,1,1,0.5);
+      font_->print(oss.str(), GL_MODULATE);
+
+      glPopMatrix();
+   }
+
    glPushMatrix();
    glTranslatef(expanded.left(), 0, 0);
 
    // draw current player's HUD
-   getCurrentPlayer().draw();
+   renderer_.drawIdleFollowers(getCurrentPlayer());
 
    // draw all players' scores
    glScalef(0.3f, 0.3f, 0.3f);
    glTranslatef(0.1f, 0.15f, 0.0f);
 
-   for (auto i(players_.begin()), end(players_.end()); i != end; ++i)
+   const std::vector<Player*>& players = state_.getPlayers();
+   for (auto i(players.begin()), end(players.end()); i != end; ++i)
    {
       bool active = &getCurrentPlayer() == *i;
 
@@ -346,7 +324,10 @@ void Scenario::setPaused(bool paused)
       paused_ = paused;
 
       if (paused)
+      {
          cancelInput();
+         machine_search_.cancel();
+      }
       else
          clock_.restart();
    }
@@ -354,28 +335,44 @@ void Scenario::setPaused(bool paused)
 
 void Scenario::simulate(sf::Time delta)
 {
-   if (!getCurrentPlayer().isHuman() && !game_over_)
+   if (!getCurrentPlayer().isHuman() && !state_.isGameOver())
    {
-      if (current_tile_)
+      if (state_.getCurrentTile() && getCurrentPlayer().getSkillLevel() == Player::SKILL_LEVEL_HARD)
       {
-         const glm::ivec2* location = board_.getNextPlaceableLocation();
+         if (!machine_thinking_)
+         {
+            machine_thinking_ = true;
+            machine_search_.start(state_, context_->nextSeed());
+            simulation_unifier_.schedule([=](sf::Time t) -> bool { return finishMachineTurn(); });
+         }
+      }
+      else if (state_.getCurrentTile() && getCurrentPlayer().getSkillLevel() != Player::SKILL_LEVEL_TRIVIAL)
+      {
+         state_.apply(machine_evaluator_.getBestMove(state_));
+         onTurnChanged();
+      }
+      else if (state_.getCurrentTile())
+      {
+         const glm::ivec2* location = state_.getNextPlaceableLocation();
          
          while (location == nullptr)
          {
-            current_tile_->rotateClockwise();
-            board_.tileRotated(*current_tile_);
-            location = board_.getNextPlaceableLocation();
+            state_.rotateTileClockwise();
+            location = state_.getNextPlaceableLocation();
          }
 
          glm::ivec2 loc = *location;
          placeTile(loc);
       }
-      else if (current_follower_)
+      else if (state_.getCurrentFollower())
       {
          placeFollower(glm::vec3(), false);
       }
       else
-         endTurn();
+      {
+         state_.endTurn();
+         onTurnChanged();
+      }
    }
 
 
@@ -442,13 +439,13 @@ void Scenario::onHover()
    {
       glm::vec3 world_coords(camera_.windowToWorld(glm::vec2(input_mgr_.getMousePosition()), floating_height_));
 
-      if (current_follower_)
+      if (state_.getCurrentFollower())
       {
-         current_follower_->setPosition(world_coords);
+         state_.getCurrentFollower()->setPosition(world_coords);
       }
-      else if (current_tile_)
+      else if (state_.getCurrentTile())
       {
-         current_tile_->setPosition(world_coords);
+         state_.getCurrentTile()->setPosition(world_coords);
       }
    }
 }
@@ -486,7 +483,7 @@ void Scenario::onRightDrag(const glm::ivec2& down_position)
 
 void Scenario::onLeftUp(const glm::ivec2& down_position)
 {
-   if (game_over_)
+   if (state_.isGameOver())
       game_.pushMenu("splash");
 
    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space))
@@ -495,14 +492,14 @@ void Scenario::onLeftUp(const glm::ivec2& down_position)
    }
    else if (getCurrentPlayer().isHuman())
    {
-      if (current_tile_)
+      if (state_.getCurrentTile())
       {
          glm::vec3 world_coords(camera_.windowToWorld(glm::vec2(input_mgr_.getMousePosition()), floating_height_));
-         glm::ivec2 board_coords(board_.getCoordinates(world_coords));
+         glm::ivec2 board_coords(state_.getBoard().getCoordinates(world_coords));
 
          placeTile(board_coords);
       }
-      else if (current_follower_)
+      else if (state_.getCurrentFollower())
       {
          glm::vec3 world_coords(camera_.windowToWorld(glm::vec2(input_mgr_.getMousePosition()), 0.1f));
 
@@ -519,18 +516,17 @@ void Scenario::onRightUp(const glm::ivec2& down_position)
    }
    else if (getCurrentPlayer().isHuman())
    {
-      if (current_tile_)
+      if (state_.getCurrentTile())
       {
          if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
              sf::Keyboard::isKeyPressed(sf::Keyboard::RShift))
          {
-            current_tile_->rotateCounterclockwise();
+            state_.rotateTileCounterclockwise();
          }
          else
          {
-            current_tile_->rotateClockwise();
+            state_.rotateTileClockwise();
          }
-         board_.tileRotated(*current_tile_);
       }
    }
 }
@@ -560,9 +556,9 @@ void Scenario::onKey(const sf::Event::KeyEvent& event, bool down)
             break;
 
          case sf::Keyboard::Tab:
-            if (camera_movement_enabled_ && current_tile_)
+            if (camera_movement_enabled_ && state_.getCurrentTile())
             {
-               const glm::ivec2* location = board_.getNextPlaceableLocation();
+               const glm::ivec2* location = state_.getNextPlaceableLocation();
 
                if (location)
                {
@@ -587,6 +583,10 @@ void Scenario::onKey(const sf::Event::KeyEvent& event, bool down)
             }
             break;
 
+         case sf::Keyboard::F3:
+            show_render_stats_ = !show_render_stats_;
+            break;
+
          default:
             break;
       }
@@ -652,6 +652,7 @@ void Scenario::onBlurred()
 bool Scenario::onClosed()
 {
    // TODO: close warning menu
+   machine_search_.cancel();
    return true;
 }
 
@@ -26,12 +26,10 @@
 
 #include "carcassonne/tile.h"
 
-#include <ctime>
+#include <cassert>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "carcassonne/asset_manager.h"
-#include "carcassonne/db/db.h"
-#include "carcassonne/db/stmt.h"
+#include "carcassonne/tileset.h"
 
 namespace carcassonne {
 
@@ -75,239 +73,90 @@ TileEdge::TileEdge(features::City* city)
 
 #pragma endregion
 
-// used to randomize starting rotation of tiles
-std::mt19937 Tile::prng_(static_cast<std::mt19937::result_type>(time(nullptr)));
-
-// Constructs a tile of one of the TYPE_EMPTY_* types
-Tile::Tile(AssetManager& asset_mgr, Type type)
-	: type_(type),
-     color_(1,1,1,1),
-	  mesh_(asset_mgr.getMesh("std-tile")),
-     texture_(nullptr),
-     rotation_(ROTATION_NONE),
-     transforms_valid_(0)
-{
-   assert(type != TYPE_PLACED && type != TYPE_FLOATING);
-   setType(type);
-}
-
-// Load tile from database
-Tile::Tile(AssetManager& asset_mgr, const std::string& name)
-   : type_(TYPE_FLOATING),
-     color_(1,1,1,1),
-     mesh_(asset_mgr.getMesh("std-tile")),
-     rotation_(static_cast<Rotation>(prng_() % 4)),
-     transforms_valid_(0)
-{
-   db::DB& db = asset_mgr.getDB();
-
-
-   db::Stmt sf(db, "SELECT type, pennants, adjacent1, adjacent2, adjacent3, adjacent4 "
-                   "FROM cc_tile_features "
-                   "WHERE id = ?");
-
-   db::Stmt s(db, "SELECT texture, cloister, "
-                  "north, north_cw, north_ccw, "
-                  "east, east_cw, east_ccw, "
-                  "south, south_cw, south_ccw, "
-                  "west, west_cw, west_ccw "
-                  "FROM cc_tiles "
-                  "WHERE name = ?");
-   s.bind(1, name);
-   if (s.step())
+Tile::Tile(const std::shared_ptr<const TilePrototype>& prototype, Rotation rotation,
+           const std::shared_ptr<features::FeaturePool>& pool)
+   : prototype_(prototype),
+     type_(TYPE_FLOATING),
+     rotation_(rotation),
+     transforms_valid_(0),
+     features_pool_(pool)
+{
+   // indexed the same as prototype->features
+   std::vector<features::Feature*> features(prototype->features.size());
+   features_.reserve(prototype->features.size() + (prototype->cloister ? 1 : 0));
+
+   // cities first, then roads, then farms
+   const TileEdge::Type types[] = { TileEdge::TYPE_CITY, TileEdge::TYPE_ROAD, TileEdge::TYPE_FARM };
+   for (int t = 0; t < 3; ++t)
    {
-      texture_ = asset_mgr.getTexture(s.getText(0));
+      if (types[t] == TileEdge::TYPE_FARM)
+         farms_begin_ = static_cast<unsigned char>(features_.size());
 
-      int cloister_id = s.getInt(1);
-      if (cloister_id > 0)
-         cloister_ = std::shared_ptr<features::Feature>(new features::Cloister(asset_mgr, cloister_id, *this));
-
-      std::vector<FeatureRef> features;
-
-      for (int i = 0; i < 4; ++i)
+      for (size_t i = 0; i < features.size(); ++i)
       {
-         int index = 2 + 3 * i;  // statement column index
-         int id = s.getInt(index);
-
-         TileEdge& edge = edges_[i];
+         const TilePrototype::Feature& f = prototype->features[i];
+         if (f.type != types[t])
+            continue;
 
-         FeatureRef ref = getFeature(asset_mgr, sf, features, id);
-         edge.type = ref.type;
-         switch (edge.type)
+         features::FeatureHandle handle;
+         switch (f.type)
          {
             case TileEdge::TYPE_CITY:
-               edge.city = ref.city;
-               break;
-
-            case TileEdge::TYPE_FARM:
-               edge.farm = ref.farm;
+               handle = pool->createCity(f.placeholder, f.pennants, *this);
                break;
 
             case TileEdge::TYPE_ROAD:
-               {
-                  edge.road = ref.road;
-                  FeatureRef cw_ref = getFeature(asset_mgr, sf, features, s.getInt(index + 1));
-                  if (cw_ref.type != TileEdge::TYPE_FARM)
-                     throw std::runtime_error("Unexpected feature type found!  Expected farm!");
-                  edge.cw_farm = cw_ref.farm;
-
-                  FeatureRef ccw_ref = getFeature(asset_mgr, sf, features, s.getInt(index + 2));
-                  if (ccw_ref.type != TileEdge::TYPE_FARM)
-                     throw std::runtime_error("Unexpected feature type found!  Expected farm!");
-                  edge.ccw_farm = ccw_ref.farm;
-               }
+               handle = pool->createRoad(f.placeholder, *this);
                break;
 
             default:
+               handle = pool->createFarm(f.placeholder, *this);
                break;
          }
+         features_.push_back(handle);
+         features[i] = &pool->get(handle);
       }
    }
-   else
-      throw std::runtime_error("Tile not found!");
-}
+   farms_end_ = static_cast<unsigned char>(features_.size());
 
-Tile::FeatureRef Tile::getFeature(AssetManager& asset_mgr, db::Stmt& sf, std::vector<FeatureRef>& features, int id)
-{
-   FeatureRef ref;
-   ref.id = id;
-
-   auto i(std::find(features.begin(), features.end(), ref));
-   if (i != features.end())
-      return *i;
-
-   sf.bind(1, id);
-   if (!sf.step())
-      throw std::runtime_error("Tile feature not found!");
-
-   ref.type = static_cast<TileEdge::Type>(sf.getInt(0));
-   switch (ref.type)
+   // adjacent cities may appear after the farms they border
+   for (size_t i = 0; i < features.size(); ++i)
    {
-      case TileEdge::TYPE_CITY:
-         ref.city = new features::City(asset_mgr, id, sf.getInt(1), *this);
-         cities_.push_back(std::shared_ptr<features::Feature>(ref.city));
-         features.push_back(ref);
-         break;
-
-      case TileEdge::TYPE_FARM:
-         {
-            ref.farm = new features::Farm(asset_mgr, id, *this);
-            farms_.push_back(std::shared_ptr<features::Feature>(ref.farm));
-            features.push_back(ref);
-
-            int adjacent[4] = { sf.getInt(2), sf.getInt(3), sf.getInt(4), sf.getInt(5) };
-            sf.reset();
-
-            for (int i = 0; i < 4; ++i)
-            {
-               if (adjacent[i] > 0)
-               {
-                  FeatureRef c = getFeature(asset_mgr, sf, features, adjacent[i]);
-                  if (c.type == TileEdge::TYPE_CITY)
-                     ref.farm->addAdjacentCity(*c.city);
-               }
-            }
-         }
-         break;
-
-      case TileEdge::TYPE_ROAD:
-         ref.road = new features::Road(asset_mgr, id, *this);
-         roads_.push_back(std::shared_ptr<features::Feature>(ref.road));
-         features.push_back(ref);
-         break;
-
-      default:
-         throw std::runtime_error("Unrecognized feature type!");
+      const std::vector<int>& cities = prototype->features[i].adjacent_cities;
+      for (auto j(cities.begin()), end(cities.end()); j != end; ++j)
+         static_cast<features::Farm*>(features[i])->addAdjacentCity(*static_cast<features::City*>(features[*j]));
    }
 
-   sf.reset();
-   return ref;
-}
-
-
-// Copy another tile (does not share feature objects)
-Tile::Tile(const Tile& other)
-   : type_(other.type_),
-     color_(other.color_),
-     mesh_(other.mesh_),
-     texture_(other.texture_),
-     rotation_(ROTATION_NONE),
-     transforms_valid_(0)
-{
    for (int i = 0; i < 4; ++i)
-      edges_[i] = other.edges_[i];
-
-   for (auto i(other.cities_.begin()), end(other.cities_.end()); i != end; ++i)
-   {
-      const features::City& city = static_cast<const features::City&>(**i);
-      features::City* new_city = new features::City(city, *this);
-
-      cities_.push_back(std::shared_ptr<features::Feature>(new_city));
-
-      for (int i = 0; i < 4; ++i)
-      {
-         TileEdge& edge = edges_[i];
-         if (edge.type == TileEdge::TYPE_CITY && edge.city == &city)
-            edge.city = new_city;
-      }
-   }
-
-   for (auto i(other.roads_.begin()), end(other.roads_.end()); i != end; ++i)
    {
-      const features::Road& road = static_cast<const features::Road&>(**i);
-      features::Road* new_road = new features::Road(road, *this);
-
-      roads_.push_back(std::shared_ptr<features::Feature>(new_road));
-
-      for (int i = 0; i < 4; ++i)
-      {
-         TileEdge& edge = edges_[i];
-         if (edge.type == TileEdge::TYPE_ROAD && edge.road == &road)
-            edge.road = new_road;
-      }
-   }
-
-   for (auto i(other.farms_.begin()), end(other.farms_.end()); i != end; ++i)
-   {
-      const features::Farm& farm = static_cast<const features::Farm&>(**i);
-      features::Farm* new_farm = new features::Farm(farm, *this);
-
-      farms_.push_back(std::shared_ptr<features::Feature>(new_farm));
-
-      for (auto i(other.cities_.begin()), end(other.cities_.end()); i != end; ++i)
+      const TilePrototype::Edge& e = prototype->edges[i];
+      TileEdge& edge = edges_[i];
+      edge.type = e.type;
+      switch (edge.type)
       {
-         const features::City& city = static_cast<const features::City&>(**i);
-         features::City& new_city = static_cast<features::City&>(
-            **(cities_.begin() + (i - other.cities_.begin())));
+         case TileEdge::TYPE_CITY:
+            edge.city = static_cast<features::City*>(features[e.feature]);
+            break;
 
-         new_farm->replaceCity(city, new_city);
-      }
+         case TileEdge::TYPE_FARM:
+            edge.farm = static_cast<features::Farm*>(features[e.feature]);
+            break;
 
-      for (int i = 0; i < 4; ++i)
-      {
-         TileEdge& edge = edges_[i];
-         if (edge.type == TileEdge::TYPE_ROAD)
-         {
-            if (edge.cw_farm == &farm)
-               edge.cw_farm = new_farm;
+         case TileEdge::TYPE_ROAD:
+            edge.road = static_cast<features::Road*>(features[e.feature]);
+            edge.cw_farm = static_cast<features::Farm*>(features[e.cw_farm]);
+            edge.ccw_farm = static_cast<features::Farm*>(features[e.ccw_farm]);
+            break;
 
-            if (edge.ccw_farm == &farm)
-               edge.ccw_farm = new_farm;
-         }
-         else if (edge.type == TileEdge::TYPE_FARM && edge.farm == &farm)
-            edge.farm = new_farm;
+         default:
+            break;
       }
    }
 
-   if (other.cloister_)
-   {
-      const features::Cloister& cloister = static_cast<const features::Cloister&>(*other.cloister_);
-      features::Cloister* new_cloister = new features::Cloister(cloister, *this);
-      cloister_.reset(new_cloister);
-   }
+   if (prototype->cloister)
+      features_.push_back(pool->createCloister(prototype->cloister_placeholder, *this));
 }
 
-
 // Sets the tile's type.  A TYPE_EMPTY_* tile can only be set to any of the
 // other TYPE_EMPTY_* types.  A TYPE_PLACED tile can't be changed to any
 // other type.  A TYPE_FLOATING tile can only be changed to TYPE_PLACED.
@@ -322,13 +171,6 @@ void Tile::setType(Type type)
             break;
          else
             type_ = type;
-
-         if (type == TYPE_EMPTY_PLACEABLE)
-            color_ = glm::vec4(0.4, 1, 0.4, 0.2);
-         else if (type == TYPE_EMPTY_PLACEABLE_IF_ROTATED)
-            color_ = glm::vec4(1, 1, 0.4, 0.2);
-         else
-            color_ = glm::vec4(1, 0.4, 0.4, 0.2);
          break;
 
       case TYPE_FLOATING:
@@ -370,6 +212,16 @@ Tile::Rotation Tile::getRotation() const
    return rotation_;
 }
 
+const TilePrototype& Tile::getPrototype() const
+{
+   return *prototype_;
+}
+
+const std::string& Tile::getTextureName() const
+{
+   return prototype_->texture_name;
+}
+
 void Tile::setPosition(const glm::vec3& position)
 {
    position_ = position;
@@ -420,32 +272,68 @@ const TileEdge& Tile::getEdge(Side side) const
    return edges_[(static_cast<int>(side) + 4 - static_cast<int>(rotation_)) % 4];
 }
 
+const TileEdge& Tile::getEdge(Side side, Rotation rotation) const
+{
+   return edges_[(static_cast<int>(side) + 4 - static_cast<int>(rotation)) % 4];
+}
+
 TileEdge& Tile::getEdge_(Side side)
 {
    return edges_[(static_cast<int>(side) + 4 - static_cast<int>(rotation_)) % 4];
 }
 
+unsigned char Tile::getEdgeSignature() const
+{
+   return prototype_->edge_signatures[rotation_];
+}
+
+unsigned char Tile::getEdgeSignature(Rotation rotation) const
+{
+   return prototype_->edge_signatures[rotation];
+}
+
 size_t Tile::getFeatureCount() const
 {
-   return cities_.size() + roads_.size() + farms_.size() + (cloister_ ? 1 : 0);
+   return features_.size();
 }
 
-std::weak_ptr<features::Feature> Tile::getFeature(size_t index)
+features::Feature* Tile::getFeature(size_t index) const
 {
-   if (index < cities_.size())
-      return std::weak_ptr<features::Feature>(cities_[index]);
+   assert(index < features_.size());
+   return &features_pool_->get(features_[index]);
+}
 
-   index -= cities_.size();
-   if (index < roads_.size())
-      return std::weak_ptr<features::Feature>(roads_[index]);
+features::FeatureHandle Tile::getFeatureHandle(size_t index) const
+{
+   return features_[index];
+}
 
-   index -= roads_.size();
-   if (index < farms_.size())
-      return std::weak_ptr<features::Feature>(farms_[index]);
+size_t Tile::getFeatureIndex(const features::Feature& feature) const
+{
+   for (size_t i = 0; i < features_.size(); ++i)
+   {
+      if (getFeature(i) == &feature)
+         return i;
+   }
+
+   assert(false);
+   return features_.size();
+}
+
+features::Cloister* Tile::getCloister_() const
+{
+   if (features_.size() == farms_end_)
+      return nullptr;
 
-   assert(index == farms_.size());
+   return static_cast<features::Cloister*>(&features_pool_->get(features_[farms_end_]));
+}
 
-   return std::weak_ptr<features::Feature>(cloister_);
+// Cities must be added before farms, since farms register the regions of
+// the cities they border.  (see getFeature() for feature order)
+void Tile::addToRegions(features::RegionStore& regions)
+{
+   for (size_t i = 0; i < features_.size(); ++i)
+      getFeature(i)->addToRegion(regions);
 }
 
 // called when a tile is placed
@@ -462,6 +350,16 @@ void Tile::closeSide(Side side, Tile* new_neighbor)
    edge.open = false;
    neighbor_edge.open = false;
 
+   if (edge.type == TileEdge::TYPE_CITY)
+      edge.city->closeEdge();
+   else if (edge.type == TileEdge::TYPE_ROAD)
+      edge.road->closeEdge();
+
+   if (neighbor_edge.type == TileEdge::TYPE_CITY)
+      neighbor_edge.city->closeEdge();
+   else if (neighbor_edge.type == TileEdge::TYPE_ROAD)
+      neighbor_edge.road->closeEdge();
+
    if (neighbor_edge.type != edge.type)
    {
       std::cerr << "Warning: edge mismatch!" << std::endl;
@@ -488,12 +386,14 @@ void Tile::closeSide(Side side, Tile* new_neighbor)
          break;
    }
 
-   if (cloister_)
-      static_cast<features::Cloister&>(*cloister_).addTile(*new_neighbor);
+   features::Cloister* cloister = getCloister_();
+   if (cloister)
+      cloister->addTile(*new_neighbor);
 
-   if (new_neighbor->cloister_)
+   features::Cloister* neighbor_cloister = new_neighbor->getCloister_();
+   if (neighbor_cloister)
    {
-      static_cast<features::Cloister&>(*new_neighbor->cloister_).addTile(*this);
+      neighbor_cloister->addTile(*this);
       new_neighbor->checkForCompleteCloister();
    }
 }
@@ -503,236 +403,77 @@ void Tile::closeDiagonal(Tile* new_diagonal_neighbor)
    if (new_diagonal_neighbor == nullptr || new_diagonal_neighbor->type_ != TYPE_PLACED)
       return;
 
-   if (cloister_)
-      static_cast<features::Cloister&>(*cloister_).addTile(*new_diagonal_neighbor);
+   features::Cloister* cloister = getCloister_();
+   if (cloister)
+      cloister->addTile(*new_diagonal_neighbor);
 
-   if (new_diagonal_neighbor->cloister_)
+   features::Cloister* neighbor_cloister = new_diagonal_neighbor->getCloister_();
+   if (neighbor_cloister)
    {
-      static_cast<features::Cloister&>(*new_diagonal_neighbor->cloister_).addTile(*this);
+      neighbor_cloister->addTile(*this);
       new_diagonal_neighbor->checkForCompleteCloister();
    }
 }
 
-void Tile::checkForCompleteFeatures()
-{
-   for (auto i(cities_.begin()), end(cities_.end()); i!= end; ++i)
-   {
-      features::Feature& feature = **i;
-      if (feature.isComplete())
-         feature.score();
-   }
-   /* We know farms are never complete until the end of the game, so we don't need:
-   for (auto i(farms_.begin()), end(farms_.end()); i!= end; ++i)
-   {
-      features::Feature& feature = **i;
-      if (feature.isComplete())
-         feature.score();
-   }
-   */
-
-   for (auto i(roads_.begin()), end(roads_.end()); i!= end; ++i)
-   {
-      features::Feature& feature = **i;
-      if (feature.isComplete())
-         feature.score();
-   }
-
-   checkForCompleteCloister();
-}
-
-void Tile::checkForCompleteCloister()
-{
-   if (cloister_ && cloister_->isComplete())
-      cloister_->score();
-}
-
-void Tile::draw() const
+void Tile::openSide(Side side, Tile* neighbor)
 {
-   glPushMatrix();
-   glTranslatef(position_.x, position_.y, position_.z);
-   /*
-   gfx::Texture::disableAny();
-   glPointSize(8);
-   glBegin(GL_POINTS);
-
-   switch(getEdge(SIDE_NORTH).type)
-   {
-   case TileEdge::TYPE_CITY: glColor3f(1,1,0); break;
-   case TileEdge::TYPE_FARM: glColor3f(0,1,0); break;
-   case TileEdge::TYPE_ROAD: glColor3f(0,0,0); break;
-   }
-   glVertex3f(0.4, 0.1, 0);
-
-   switch(getEdge(SIDE_EAST).type)
-   {
-   case TileEdge::TYPE_CITY: glColor3f(1,1,0); break;
-   case TileEdge::TYPE_FARM: glColor3f(0,1,0); break;
-   case TileEdge::TYPE_ROAD: glColor3f(0,0,0); break;
-   }
-   glVertex3f(0, 0.1, 0.4);
-   
-   switch(getEdge(SIDE_SOUTH).type)
-   {
-   case TileEdge::TYPE_CITY: glColor3f(1,1,0); break;
-   case TileEdge::TYPE_FARM: glColor3f(0,1,0); break;
-   case TileEdge::TYPE_ROAD: glColor3f(0,0,0); break;
-   }
-   glVertex3f(-0.4, 0.1, 0);
-   
-   switch(getEdge(SIDE_WEST).type)
-   {
-   case TileEdge::TYPE_CITY: glColor3f(1,1,0); break;
-   case TileEdge::TYPE_FARM: glColor3f(0,1,0); break;
-   case TileEdge::TYPE_ROAD: glColor3f(0,0,0); break;
-   }
-   glVertex3f(0, 0.1, -0.4);
-   glEnd();*/
-
-
-
-   float angle = -90.0f * static_cast<int>(rotation_);
-   glRotatef(angle, 0, 1, 0);
-
-   /*
-   gfx::Texture::disableAny();
-   glDisable(GL_LIGHTING);
-   glBegin(GL_LINES);
-   glColor3f(1,0,0);
-   glVertex3f(0,0,0);glVertex3f(0.5,0,0);
-   glColor3f(0,0,1);
-   glVertex3f(0,0,0);glVertex3f(0,0,0.5);
-   glEnd();
-   glEnable(GL_LIGHTING);*/
-
-   glColor4fv(glm::value_ptr(color_));
-   bool disable_depth_write = color_.a < 1;
-
-   if (texture_)
-      texture_->enable(GL_MODULATE);
-   else
-      gfx::Texture::disableAny();
-
-   if (disable_depth_write)
-      glDepthMask(false);
-
-   if (mesh_)
-      mesh_->drawBase();
-
-   if (disable_depth_write)
-      glDepthMask(true);
-
+   if (neighbor == nullptr || neighbor->type_ != TYPE_PLACED)
+      return;
 
+   Side neighbor_side = static_cast<Side>((side + 2) % 4);
+   neighbor->getEdge_(neighbor_side).open = true;
+   getEdge_(side).open = true;
 
+   if (neighbor->getEdge_(neighbor_side).type != getEdge_(side).type)
+      return;
 
-   glPopMatrix();
+   openDiagonal(neighbor);
 }
 
-void Tile::drawPlaceholders() const
+void Tile::openDiagonal(Tile* diagonal_neighbor)
 {
-   glPushMatrix();
-   glTranslatef(position_.x, position_.y, position_.z);
-   float angle = -90.0f * static_cast<int>(rotation_);
-   glRotatef(angle, 0, 1, 0);
-
-   for (auto i(cities_.begin()), end(cities_.end()); i!= end; ++i)
-      (*i)->drawPlaceholder();
-
-   for (auto i(farms_.begin()), end(farms_.end()); i!= end; ++i)
-      (*i)->drawPlaceholder();
-
-   for (auto i(roads_.begin()), end(roads_.end()); i!= end; ++i)
-      (*i)->drawPlaceholder();
+   if (diagonal_neighbor == nullptr || diagonal_neighbor->type_ != TYPE_PLACED)
+      return;
 
-   if (cloister_)
-      cloister_->drawPlaceholder();
+   features::Cloister* cloister = getCloister_();
+   if (cloister)
+      cloister->removeTile(*diagonal_neighbor);
 
-   glPopMatrix();
+   features::Cloister* neighbor_cloister = diagonal_neighbor->getCloister_();
+   if (neighbor_cloister)
+      neighbor_cloister->removeTile(*this);
 }
 
-void Tile::setPlaceholderColor(const glm::vec4& color)
+void Tile::lift()
 {
-   for (auto i(cities_.begin()), end(cities_.end()); i!= end; ++i)
-      (*i)->setPlaceholderColor(color);
-
-   for (auto i(farms_.begin()), end(farms_.end()); i!= end; ++i)
-      (*i)->setPlaceholderColor(color);
+   if (type_ != TYPE_PLACED)
+      return;
 
-   for (auto i(roads_.begin()), end(roads_.end()); i!= end; ++i)
-      (*i)->setPlaceholderColor(color);
+   for (size_t i = 0; i < features_.size(); ++i)
+      getFeature(i)->removeFromRegion();
 
-   if (cloister_)
-      cloister_->setPlaceholderColor(color);
+   type_ = TYPE_FLOATING;
 }
 
-void Tile::replaceCity(const features::City& old_city, features::City& new_city)
+void Tile::checkForCompleteFeatures()
 {
-   for (auto i(cities_.begin()), end(cities_.end()); i!= end; ++i)
-   {
-      std::shared_ptr<features::Feature>& ptr = *i;
-
-      if (&old_city == ptr.get())
-         ptr = new_city.shared_from_this();
-   }
-
-   for (auto i(farms_.begin()), end(farms_.end()); i!= end; ++i)
+   // We know farms are never complete until the end of the game, so only
+   // cities and roads need to be checked.
+   for (size_t i = 0; i < farms_begin_; ++i)
    {
-      std::shared_ptr<features::Feature>& ptr = *i;
-      features::Farm& farm = static_cast<features::Farm&>(*ptr);
-
-      farm.replaceCity(old_city, new_city);
+      features::Feature& feature = *getFeature(i);
+      if (feature.isComplete())
+         feature.score();
    }
 
-   for (int i = 0; i < 4; ++i)
-   {
-      TileEdge& edge = edges_[i];
-      if (edge.type == TileEdge::TYPE_CITY && edge.city == &old_city)
-         edge.city = &new_city;
-   }
+   checkForCompleteCloister();
 }
 
-void Tile::replaceFarm(const features::Farm& old_farm, features::Farm& new_farm)
+void Tile::checkForCompleteCloister()
 {
-   for (auto i(farms_.begin()), end(farms_.end()); i!= end; ++i)
-   {
-      std::shared_ptr<features::Feature>& ptr = *i;
-
-      if (&old_farm == ptr.get())
-         ptr = new_farm.shared_from_this();
-   }
-
-   for (int i = 0; i < 4; ++i)
-   {
-      TileEdge& edge = edges_[i];
-      if (edge.type == TileEdge::TYPE_FARM && edge.farm == &old_farm)
-         edge.farm = &new_farm;
-
-      else if (edge.type == TileEdge::TYPE_ROAD)
-      {
-         if (edge.cw_farm == &old_farm)
-            edge.cw_farm = &new_farm;
-
-         if (edge.ccw_farm == &old_farm)
-            edge.ccw_farm = &new_farm;
-      }
-   }
+   features::Cloister* cloister = getCloister_();
+   if (cloister && cloister->isComplete())
+      cloister->score();
 }
 
-void Tile::replaceRoad(const features::Road& old_road, features::Road& new_road)
-{
-   for (auto i(roads_.begin()), end(roads_.end()); i!= end; ++i)
-   {
-      std::shared_ptr<features::Feature>& ptr = *i;
-
-      if (&old_road == ptr.get())
-         ptr = new_road.shared_from_this();
-   }
-
-   for (int i = 0; i < 4; ++i)
-   {
-      TileEdge& edge = edges_[i];
-      if (edge.type == TileEdge::TYPE_ROAD && edge.road == &old_road)
-         edge.road = &new_road;
-   }
-}
-   
 } // namespace carcassonne
@@ -0,0 +1,252 @@
+// Copyright (c) 2013 Dougrist Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Author: Benjamin Crist
+// File: carcassonne/tileset.h
+//
+// Immutable descriptions of the tiles in a tileset.  Each distinct tile is
+// loaded from the database once into a TilePrototype, which describes its
+// edges, features, and follower placeholders.  Tile objects refer to their
+// prototype instead of querying the database, and a Pile is just a list of
+// prototype indices.
+
+#include "carcassonne/tileset.h"
+
+#include <algorithm>
+
+#include "carcassonne/db/db.h"
+#include "carcassonne/db/stmt.h"
+
+namespace carcassonne {
+
+Tileset::Tileset(db::DB& db, const std::string& name)
+   : name_(name)
+{
+   db::Stmt s(db, "SELECT id, starting_tile FROM cc_tilesets WHERE name = ?");
+   s.bind(1, name);
+   if (!s.step())
+      throw std::runtime_error("Tileset not found!");
+
+   db::Stmt st(db, "SELECT texture, cloister, "
+                   "north, north_cw, north_ccw, "
+                   "east, east_cw, east_ccw, "
+                   "south, south_cw, south_ccw, "
+                   "west, west_cw, west_ccw "
+                   "FROM cc_tiles "
+                   "WHERE name = ?");
+
+   db::Stmt sf(db, "SELECT type, pennants, adjacent1, adjacent2, adjacent3, adjacent4, "
+                   "follower_orientation, follower_x, follower_z, follower_r "
+                   "FROM cc_tile_features "
+                   "WHERE id = ?");
+
+   db::Stmt stt(db, "SELECT tile, quantity FROM cc_tileset_tiles WHERE tileset_id = ?");
+   stt.bind(1, s.getInt(0));
+   while (stt.step())
+   {
+      size_t index = loadPrototype(st, sf, stt.getText(0));
+      quantities_[index] += stt.getInt(1);
+   }
+
+   starting_tile_ = loadPrototype(st, sf, s.getText(1));
+}
+
+const std::string& Tileset::getName() const
+{
+   return name_;
+}
+
+size_t Tileset::size() const
+{
+   return prototypes_.size();
+}
+
+const TilePrototype& Tileset::getPrototype(size_t index) const
+{
+   return prototypes_[index];
+}
+
+int Tileset::getQuantity(size_t index) const
+{
+   return quantities_[index];
+}
+
+size_t Tileset::getStartingTile() const
+{
+   return starting_tile_;
+}
+
+// Returns the index of the prototype named tile_name, loading it if it
+// hasn't been loaded yet.
+size_t Tileset::loadPrototype(db::Stmt& s, db::Stmt& sf, const std::string& tile_name)
+{
+   for (size_t i = 0; i < prototypes_.size(); ++i)
+      if (prototypes_[i].name == tile_name)
+         return i;
+
+   s.bind(1, tile_name);
+   if (!s.step())
+      throw std::runtime_error("Tile not found!");
+
+   prototypes_.push_back(TilePrototype());
+   quantities_.push_back(0);
+   TilePrototype& prototype = prototypes_.back();
+
+   prototype.name = tile_name;
+   prototype.index = prototypes_.size() - 1;
+   prototype.texture_name = s.getText(0);
+
+   int cloister_id = s.getInt(1);
+   prototype.cloister = cloister_id > 0;
+
+   std::vector<int> ids;   // database ids of prototype.features
+
+   for (int i = 0; i < 4; ++i)
+   {
+      int index = 2 + 3 * i;  // statement column index
+
+      TilePrototype::Edge& edge = prototype.edges[i];
+      edge.feature = loadFeature(sf, prototype, ids, s.getInt(index));
+      edge.type = prototype.features[edge.feature].type;
+      edge.cw_farm = -1;
+      edge.ccw_farm = -1;
+
+      if (edge.type == TileEdge::TYPE_ROAD)
+      {
+         edge.cw_farm = loadFeature(sf, prototype, ids, s.getInt(index + 1));
+         if (prototype.features[edge.cw_farm].type != TileEdge::TYPE_FARM)
+            throw std::runtime_error("Unexpected feature type found!  Expected farm!");
+
+         edge.ccw_farm = loadFeature(sf, prototype, ids, s.getInt(index + 2));
+         if (prototype.features[edge.ccw_farm].type != TileEdge::TYPE_FARM)
+            throw std::runtime_error("Unexpected feature type found!  Expected farm!");
+      }
+   }
+   s.reset();
+
+   if (prototype.cloister)
+   {
+      sf.bind(1, cloister_id);
+      if (!sf.step())
+         throw std::runtime_error("Tile feature not found!");
+
+      prototype.cloister_placeholder = loadPlaceholder(sf);
+      sf.reset();
+   }
+
+   // Rotating a tile clockwise moves the edge on each side to the next side,
+   // so each rotation of the signature is the unrotated signature rotated
+   // left by 2 bits per quarter turn.
+   unsigned int signature = 0;
+   for (int i = 0; i < 4; ++i)
+      signature |= (static_cast<unsigned int>(prototype.edges[i].type) & 0x3) << (2 * i);
+
+   for (int r = 0; r < 4; ++r)
+      prototype.edge_signatures[r] = static_cast<unsigned char>(((signature << (2 * r)) | (signature >> (8 - 2 * r))) & 0xFF);
+
+   // Each side of an empty location is either unconstrained or requires
+   // one edge type, so there are at most 16 kinds of location per rotation
+   // where the tile fits.
+   for (unsigned int constraints = 1; constraints < 256; ++constraints)
+   {
+      unsigned int edge_mask = 0;
+      unsigned int required_edges = 0;
+      for (int side = 0; side < 4; ++side)
+      {
+         unsigned int constraint = (constraints >> (2 * side)) & 0x3;
+         if (constraint != 0)
+         {
+            edge_mask |= 0x3 << (2 * side);
+            required_edges |= (constraint - 1) << (2 * side);
+         }
+      }
+
+      for (int r = 0; r < 4; ++r)
+      {
+         if ((prototype.edge_signatures[r] & edge_mask) == required_edges)
+         {
+            prototype.fitting_constraints.push_back(static_cast<unsigned char>(constraints));
+            break;
+         }
+      }
+   }
+
+   return prototypes_.size() - 1;
+}
+
+// Creates the placeholder follower for the feature which sf has just
+// stepped to.
+Follower Tileset::loadPlaceholder(db::Stmt& sf)
+{
+   glm::vec3 position(static_cast<float>(sf.getDouble(7)), 0.0f, static_cast<float>(sf.getDouble(8)));
+   return Follower(position, sf.getInt(6) != 0, static_cast<float>(sf.getDouble(9)));
+}
+
+// Returns the index in prototype.features of the feature with the database
+// id specified, loading it (and the cities adjacent to it if it is a farm)
+// if it hasn't been loaded yet.
+int Tileset::loadFeature(db::Stmt& sf, TilePrototype& prototype, std::vector<int>& ids, int id)
+{
+   auto i(std::find(ids.begin(), ids.end(), id));
+   if (i != ids.end())
+      return i - ids.begin();
+
+   sf.bind(1, id);
+   if (!sf.step())
+      throw std::runtime_error("Tile feature not found!");
+
+   int index = prototype.features.size();
+   ids.push_back(id);
+   prototype.features.push_back(TilePrototype::Feature());
+   TilePrototype::Feature& feature = prototype.features.back();
+
+   feature.type = static_cast<TileEdge::Type>(sf.getInt(0));
+   if (feature.type != TileEdge::TYPE_CITY &&
+       feature.type != TileEdge::TYPE_FARM &&
+       feature.type != TileEdge::TYPE_ROAD)
+      throw std::runtime_error("Unrecognized feature type!");
+
+   feature.pennants = feature.type == TileEdge::TYPE_CITY ? sf.getInt(1) : 0;
+   feature.placeholder = loadPlaceholder(sf);
+
+   int adjacent[4] = { sf.getInt(2), sf.getInt(3), sf.getInt(4), sf.getInt(5) };
+   sf.reset();
+
+   if (feature.type == TileEdge::TYPE_FARM)
+   {
+      for (int j = 0; j < 4; ++j)
+      {
+         if (adjacent[j] > 0)
+         {
+            int c = loadFeature(sf, prototype, ids, adjacent[j]);
+
+            // prototype.features may have been reallocated
+            std::vector<int>& cities = prototype.features[index].adjacent_cities;
+            if (prototype.features[c].type == TileEdge::TYPE_CITY &&
+                std::find(cities.begin(), cities.end(), c) == cities.end())
+               cities.push_back(c);
+         }
+      }
+   }
+
+   return index;
+}
+
+} // namespace carcassonne